@@ -0,0 +1,775 @@
+//============================================================================
+// Name        : bench.cpp
+// Author      : Akash Banerjee (CS18MTECH11023)
+// Description : Benchmark suite and driver for the solvers in C++11, Ansi-style
+//               "bench generate DIR" writes a reproducible suite: random
+//               3-SAT at the phase transition, pigeonhole, Tseitin parity
+//               on a torus, random graph 3-coloring and over-constrained
+//               random 3-SAT as unweighted MaxSAT.  The same seed gives the
+//               same files on any platform.
+//               "bench run DIR" runs every solver on every instance of its
+//               kind with a timeout, checks the answers, and collects wall
+//               time, peak RSS and, from cdcl --stats, the search counters
+//               into CSV and JSON; with --baseline=FILE it diffs the times
+//               and answers against an earlier CSV and fails on a
+//               regression.
+//============================================================================
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dimacs.h"
+
+typedef std::vector<int> clause_t;
+typedef std::vector<clause_t> sat_instance_t;
+
+//  Counters read from the JSON that cdcl --stats writes, in CSV order.
+static const char* counter_names[] = { "decisions", "propagations",
+        "conflicts", "restarts", "learnt_clauses", "deleted_clauses",
+        "average_lbd", "parse_seconds", "preprocess_seconds",
+        "propagate_seconds", "analyze_seconds", "reduce_seconds" };
+static const unsigned no_of_counters = sizeof(counter_names)
+        / sizeof(counter_names[0]);
+
+//  A command line token containing this is replaced by the path of a
+//  temporary file, read back as cdcl --stats output after the run.
+static const std::string stats_placeholder = "%stats";
+
+//  splitmix64; std::uniform_int_distribution and the like differ between
+//  standard libraries, which would make the suite differ as well.
+class bench_random_t {
+    uint64_t state;
+
+ public:
+    explicit bench_random_t(uint64_t seed)
+            : state { seed } {
+    }
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    //  Uniform in [0, n).
+    unsigned below(unsigned n) {
+        return static_cast<unsigned>(next() % n);
+    }
+};
+
+//Input :   No. of variables, clause width, clauses per variable and a
+//          random source.
+//
+//Output:   Returns a uniform random k-SAT instance: every clause has k
+//          distinct variables with random signs.
+sat_instance_t random_ksat(unsigned no_of_variables, unsigned k, double ratio,
+                           bench_random_t& random) {
+    sat_instance_t sat_instance(
+            static_cast<size_t>(std::lround(ratio * no_of_variables)));
+    for (auto& clause : sat_instance) {
+        while (clause.size() < k) {
+            int variable = static_cast<int>(random.below(no_of_variables)) + 1;
+            if (std::find(clause.begin(), clause.end(), variable) == clause.end()
+                    && std::find(clause.begin(), clause.end(), -variable)
+                            == clause.end())
+                clause.push_back(random.below(2) ? variable : -variable);
+        }
+    }
+    return sat_instance;
+}
+
+//Input :   No. of holes.
+//
+//Output:   Returns the pigeonhole formula for one pigeon more than that,
+//          which is unsatisfiable; pigeon i sits in hole j if variable
+//          i * holes + j + 1 is true.
+sat_instance_t pigeonhole(unsigned holes) {
+    sat_instance_t sat_instance;
+    for (unsigned i = 0; i <= holes; i++) {
+        clause_t clause;
+        for (unsigned j = 0; j < holes; j++)
+            clause.push_back(static_cast<int>(i * holes + j + 1));
+        sat_instance.push_back(clause);
+    }
+    for (unsigned j = 0; j < holes; j++)
+        for (unsigned i = 0; i <= holes; i++)
+            for (unsigned l = i + 1; l <= holes; l++)
+                sat_instance.push_back({ -static_cast<int>(i * holes + j + 1),
+                        -static_cast<int>(l * holes + j + 1) });
+    return sat_instance;
+}
+
+//Input :   Width and height of a torus, both at least 3, whether the
+//          formula should be satisfiable, and a random source.
+//
+//Output:   Returns the Tseitin parity formula of the torus: a variable per
+//          edge, and at each vertex the XOR of its four edges must equal a
+//          random charge.  The formula is satisfiable iff the charges add
+//          up to an even number, which the charge of vertex 0 is set for.
+sat_instance_t tseitin_torus(unsigned width, unsigned height, bool satisfiable,
+                             bench_random_t& random) {
+    //  Edge to the right of (x, y), and the one below it.
+    auto right = [width](unsigned x, unsigned y) {
+        return static_cast<int>(2 * (y * width + x) + 1);
+    };
+    auto down = [width](unsigned x, unsigned y) {
+        return static_cast<int>(2 * (y * width + x) + 2);
+    };
+    std::vector<unsigned> charges(width * height);
+    unsigned total = 0;
+    for (auto& a : charges)
+        total += a = random.below(2);
+    if (total % 2 != (satisfiable ? 0u : 1u))
+        charges[0] ^= 1;
+
+    sat_instance_t sat_instance;
+    for (unsigned y = 0; y < height; y++) {
+        for (unsigned x = 0; x < width; x++) {
+            int edges[4] = { right(x, y), down(x, y),
+                    right((x + width - 1) % width, y),
+                    down(x, (y + height - 1) % height) };
+            //  Rule out every assignment of the four of the wrong parity.
+            for (unsigned pattern = 0; pattern < 16; pattern++) {
+                unsigned parity = 0;
+                clause_t clause;
+                for (unsigned i = 0; i < 4; i++) {
+                    bool value = (pattern >> i) & 1;
+                    parity ^= value;
+                    clause.push_back(value ? -edges[i] : edges[i]);
+                }
+                if (parity != charges[y * width + x])
+                    sat_instance.push_back(clause);
+            }
+        }
+    }
+    return sat_instance;
+}
+
+//Input :   No. of vertices, average degree, no. of colors and a random
+//          source.
+//
+//Output:   Returns the k-coloring formula of a random graph with that many
+//          edges; vertex v has color c if variable v * k + c + 1 is true.
+sat_instance_t graph_coloring(unsigned no_of_vertices, double average_degree,
+                              unsigned k, bench_random_t& random) {
+    auto color = [k](unsigned vertex, unsigned c) {
+        return static_cast<int>(vertex * k + c + 1);
+    };
+    sat_instance_t sat_instance;
+    for (unsigned v = 0; v < no_of_vertices; v++) {
+        clause_t clause;
+        for (unsigned c = 0; c < k; c++)
+            clause.push_back(color(v, c));
+        sat_instance.push_back(clause);
+        for (unsigned c = 0; c < k; c++)
+            for (unsigned d = c + 1; d < k; d++)
+                sat_instance.push_back({ -color(v, c), -color(v, d) });
+    }
+    size_t no_of_edges = static_cast<size_t>(
+            std::lround(average_degree * no_of_vertices / 2));
+    std::set<std::pair<unsigned, unsigned>> edges;
+    while (edges.size() < no_of_edges) {
+        unsigned u = random.below(no_of_vertices);
+        unsigned v = random.below(no_of_vertices);
+        if (u == v || !edges.insert({ std::min(u, v), std::max(u, v) }).second)
+            continue;
+        for (unsigned c = 0; c < k; c++)
+            sat_instance.push_back({ -color(u, c), -color(v, c) });
+    }
+    return sat_instance;
+}
+
+//Input :   Path, the formula, its no. of variables and a comment line.
+//
+//Output:   Write the formula there in DIMACS format; returns false if
+//          that failed.
+bool write_dimacs(const std::string& path, const sat_instance_t& sat_instance,
+                  unsigned no_of_variables, const std::string& comment) {
+    std::ofstream out(path);
+    out << "c " << comment << '\n';
+    out << "p cnf " << no_of_variables << ' ' << sat_instance.size() << '\n';
+    for (auto& clause : sat_instance) {
+        for (auto a : clause)
+            out << a << ' ';
+        out << "0\n";
+    }
+    out.close();
+    return static_cast<bool>(out);
+}
+
+//Input :   Directory to write to, and no. of seeds per random family.
+//
+//Output:   Write the suite there, creating the directory if need be, one
+//          "<family>.<parameters>.cnf" per instance; families starting with
+//          "maxsat" are MaxSAT instances.  Returns false if a file could
+//          not be written.
+bool generate_suite(const std::string& directory, unsigned no_of_seeds) {
+    mkdir(directory.c_str(), 0755);
+    bool ok = true;
+    auto write = [&](const std::string& name, const sat_instance_t& sat_instance,
+                     unsigned no_of_variables) {
+        ok = write_dimacs(directory + "/" + name + ".cnf", sat_instance,
+                          no_of_variables, "bench " + name) && ok;
+    };
+    for (unsigned seed = 1; seed <= no_of_seeds; seed++) {
+        std::string suffix = ".s" + std::to_string(seed);
+        for (unsigned n : { 50, 100, 150, 200 }) {
+            bench_random_t random(seed * 1000003ull + n);
+            write("random3sat.n" + std::to_string(n) + suffix,
+                  random_ksat(n, 3, 4.26, random), n);
+        }
+        for (unsigned n : { 50, 100, 150 }) {
+            bench_random_t random(seed * 2000003ull + n);
+            write("coloring3.n" + std::to_string(n) + suffix,
+                  graph_coloring(n, 4.4, 3, random), 3 * n);
+        }
+        for (unsigned width : { 4, 6 }) {
+            for (bool satisfiable : { true, false }) {
+                bench_random_t random(seed * 3000017ull + width * 2
+                        + satisfiable);
+                write(std::string(satisfiable ? "parity-sat" : "parity-unsat")
+                              + ".t" + std::to_string(width) + "x8" + suffix,
+                      tseitin_torus(width, 8, satisfiable, random),
+                      2 * width * 8);
+            }
+        }
+        for (unsigned n : { 20, 30, 40 }) {
+            bench_random_t random(seed * 4000037ull + n);
+            write("maxsat3.n" + std::to_string(n) + suffix,
+                  random_ksat(n, 3, 6, random), n);
+        }
+    }
+    for (unsigned holes = 6; holes <= 9; holes++)
+        write("php.h" + std::to_string(holes), pigeonhole(holes),
+              holes * (holes + 1));
+    return ok;
+}
+
+struct solver_t {
+    std::string name;
+    std::string command;
+    bool maxsat;
+};
+
+struct run_result_t {
+    std::string solver;
+    std::string instance;
+    std::string family;
+    //  SAT or UNSAT for SAT solvers, OPT for a MaxSAT solver that finished,
+    //  or TIMEOUT, WRONG (an answer that does not check out) or ERROR.
+    std::string status;
+    double wall_seconds = 0;
+    long peak_rss_kb = 0;
+    //  No. of clauses satisfied by the best model a MaxSAT solver gave,
+    //  -1 if none.
+    long value = -1;
+    std::vector<double> counters = std::vector<double>(no_of_counters, -1);
+};
+
+//Input :   A command, split into words, files for its stdin and stdout,
+//          and a timeout in seconds.
+//
+//Output:   Run it as a process group of its own, killed once the timeout
+//          passes.  Sets wall_seconds and peak_rss_kb, and returns "ok" if
+//          it exited with status 0, "TIMEOUT" if it was killed and "ERROR"
+//          otherwise.
+std::string run_process(const std::vector<std::string>& words,
+                        const std::string& input, const std::string& output,
+                        double timeout, double& wall_seconds,
+                        long& peak_rss_kb) {
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0)
+        return "ERROR";
+    if (pid == 0) {
+        setpgid(0, 0);
+        int in = open(input.c_str(), O_RDONLY);
+        int out = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        int null = open("/dev/null", O_WRONLY);
+        if (in < 0 || out < 0 || null < 0)
+            _exit(127);
+        dup2(in, STDIN_FILENO);
+        dup2(out, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        std::vector<char*> argv;
+        for (auto& a : words)
+            argv.push_back(const_cast<char*>(a.c_str()));
+        argv.push_back(nullptr);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    setpgid(pid, pid);
+
+    int status = 0;
+    struct rusage usage;
+    bool timed_out = false;
+    while (true) {
+        pid_t done = wait4(pid, &status, WNOHANG, &usage);
+        if (done == pid)
+            break;
+        if (done < 0 && errno != EINTR) {
+            //  Still kill the group, or a solver left behind would skew the
+            //  timings of the runs after it.
+            kill(-pid, SIGKILL);
+            while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR)
+                ;
+            return "ERROR";
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+                - start;
+        if (elapsed.count() >= timeout) {
+            kill(-pid, SIGKILL);
+            while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR)
+                ;
+            timed_out = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    wall_seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    peak_rss_kb = usage.ru_maxrss;
+    if (timed_out) {
+        wall_seconds = timeout;
+        return "TIMEOUT";
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? "ok" : "ERROR";
+}
+
+//Input :   A formula and a model, as literals in any order.
+//
+//Output:   Returns the no. of clauses the model satisfies.
+unsigned satisfied_clauses(const dimacs_instance_t& formula,
+                           const std::vector<int>& model) {
+    std::vector<int> assignment(formula.no_of_variables + 1);
+    for (auto a : model)
+        if (abs(a) <= static_cast<int>(formula.no_of_variables))
+            assignment[abs(a)] = a;
+    unsigned satisfied = 0;
+    for (unsigned i = 0; i < formula.no_of_clauses; i++) {
+        for (const int* a = formula.begin(i); a != formula.end(i); a++) {
+            if (assignment[abs(*a)] == *a) {
+                satisfied++;
+                break;
+            }
+        }
+    }
+    return satisfied;
+}
+
+//Input :   Output of a SAT solver and the formula it solved.
+//
+//Output:   Returns SAT if it gave a model of the formula, UNSAT if it said
+//          so, and WRONG otherwise.
+std::string check_sat_output(const std::string& text,
+                             const dimacs_instance_t& formula) {
+    std::istringstream in(text);
+    std::string answer;
+    in >> answer;
+    if (answer == "UNSAT")
+        return "UNSAT";
+    if (answer != "SAT")
+        return "WRONG";
+    std::vector<int> model;
+    int literal;
+    while (in >> literal && literal != 0)
+        model.push_back(literal);
+    return satisfied_clauses(formula, model) == formula.no_of_clauses ?
+            "SAT" : "WRONG";
+}
+
+//Input :   Output of a MaxSAT solver, the formula it solved and a
+//          reference to return the value of its last answer in.
+//
+//Output:   The answers are lines holding the no. of satisfied clauses,
+//          each followed by a line with the model, possibly after a "v".
+//          Sets value to the last that fully arrived and returns "ok" if
+//          its model satisfies that many clauses, "WRONG" if not, and
+//          "ERROR" if there is none.
+std::string check_maxsat_output(const std::string& text,
+                                const dimacs_instance_t& formula,
+                                long& value) {
+    std::vector<std::string> lines;
+    std::istringstream in(text);
+    for (std::string line; std::getline(in, line);)
+        lines.push_back(line);
+    for (size_t i = lines.size(); i-- > 1;) {
+        const std::string& count = lines[i - 1];
+        if (count.empty()
+                || count.find_first_not_of("0123456789") != std::string::npos)
+            continue;
+        std::istringstream model_line(lines[i]);
+        std::vector<int> model;
+        std::string token;
+        bool terminated = false;
+        while (model_line >> token) {
+            if (token == "v")
+                continue;
+            int literal = atoi(token.c_str());
+            if (literal == 0) {
+                terminated = true;
+                break;
+            }
+            model.push_back(literal);
+        }
+        if (!terminated)
+            continue;
+        value = atol(count.c_str());
+        return satisfied_clauses(formula, model)
+                >= static_cast<unsigned long>(value) ? "ok" : "WRONG";
+    }
+    return "ERROR";
+}
+
+//Input :   JSON text, a key and a reference to return its value in.
+//
+//Output:   Returns true if "key": is followed by a number, which is then
+//          read into value; enough for the flat objects cdcl writes.
+bool json_number(const std::string& text, const std::string& key,
+                 double& value) {
+    size_t position = text.find('"' + key + "\":");
+    if (position == std::string::npos)
+        return false;
+    const char* begin = text.c_str() + position + key.size() + 3;
+    char* end;
+    value = strtod(begin, &end);
+    return end != begin;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+//Input :   A solver, an instance, the formula in it and the timeout.
+//
+//Output:   Run the solver on it once and return what happened.
+run_result_t run_once(const solver_t& solver, const std::string& path,
+                      const dimacs_instance_t& formula, double timeout) {
+    run_result_t result;
+    char output[] = "/tmp/bench.out.XXXXXX";
+    char stats[] = "/tmp/bench.stats.XXXXXX";
+    int output_fd = mkstemp(output);
+    int stats_fd = mkstemp(stats);
+    if (output_fd < 0 || stats_fd < 0) {
+        result.status = "ERROR";
+        return result;
+    }
+    close(output_fd);
+    close(stats_fd);
+
+    std::vector<std::string> words;
+    std::istringstream command(solver.command);
+    for (std::string word; command >> word;) {
+        size_t position = word.find(stats_placeholder);
+        if (position != std::string::npos)
+            word.replace(position, stats_placeholder.size(), stats);
+        words.push_back(word);
+    }
+    std::string status = run_process(words, path, output, timeout,
+                                     result.wall_seconds, result.peak_rss_kb);
+    std::string text = read_file(output);
+    if (solver.maxsat) {
+        //  A local search may never stop; the best it printed still counts.
+        std::string checked = check_maxsat_output(text, formula, result.value);
+        if (checked == "WRONG")
+            result.status = checked;
+        else if (status == "ok")
+            result.status = checked == "ok" ? "OPT" : "ERROR";
+        else
+            result.status = status;
+    } else if (status == "ok") {
+        result.status = check_sat_output(text, formula);
+    } else {
+        result.status = status;
+    }
+
+    std::string json = read_file(stats);
+    for (unsigned i = 0; i < no_of_counters; i++)
+        json_number(json, counter_names[i], result.counters[i]);
+    unlink(output);
+    unlink(stats);
+    return result;
+}
+
+//Input :   Suite directory.
+//
+//Output:   Returns the names of the instances in it, sorted.
+std::vector<std::string> list_instances(const std::string& directory) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return names;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".cnf") == 0)
+            names.push_back(name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+//Input :   The results of all the runs.
+//
+//Output:   A SAT solver that said UNSAT where another gave a model that
+//          checks out is marked WRONG.
+void cross_check(std::vector<run_result_t>& results) {
+    std::set<std::string> satisfiable;
+    for (auto& a : results)
+        if (a.status == "SAT")
+            satisfiable.insert(a.instance);
+    for (auto& a : results)
+        if (a.status == "UNSAT" && satisfiable.count(a.instance))
+            a.status = "WRONG";
+}
+
+void write_csv(std::ostream& out, const std::vector<run_result_t>& results) {
+    out << "solver,instance,family,status,wall_seconds,peak_rss_kb,value";
+    for (auto a : counter_names)
+        out << ',' << a;
+    out << '\n';
+    for (auto& a : results) {
+        out << a.solver << ',' << a.instance << ',' << a.family << ','
+            << a.status << ',' << a.wall_seconds << ',' << a.peak_rss_kb << ','
+            << a.value;
+        for (auto b : a.counters)
+            out << ',' << b;
+        out << '\n';
+    }
+}
+
+void write_json(std::ostream& out, const std::vector<run_result_t>& results) {
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const run_result_t& a = results[i];
+        out << "  {\"solver\": \"" << a.solver << "\", \"instance\": \""
+            << a.instance << "\", \"family\": \"" << a.family
+            << "\", \"status\": \"" << a.status << "\", \"wall_seconds\": "
+            << a.wall_seconds << ", \"peak_rss_kb\": " << a.peak_rss_kb
+            << ", \"value\": " << a.value;
+        for (unsigned j = 0; j < no_of_counters; j++)
+            if (a.counters[j] >= 0)
+                out << ", \"" << counter_names[j] << "\": " << a.counters[j];
+        out << (i + 1 < results.size() ? "},\n" : "}\n");
+    }
+    out << "]\n";
+}
+
+//Input :   Results, an earlier CSV written by write_csv, the relative
+//          slowdown to tolerate and the wall time below which runs are
+//          too short to compare.
+//
+//Output:   Print how every run that is in both compares, and return the
+//          no. of regressions: a run that got an answer before and none,
+//          or a different one, now, or is slower beyond the tolerance.
+unsigned diff_baseline(const std::vector<run_result_t>& results,
+                       const std::string& path, double tolerance,
+                       double min_seconds) {
+    std::map<std::pair<std::string, std::string>,
+            std::pair<std::string, double>> baseline;
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::istringstream row(line);
+        for (std::string field; std::getline(row, field, ',');)
+            fields.push_back(field);
+        if (fields.size() >= 5)
+            baseline[{ fields[0], fields[1] }] = { fields[3],
+                    atof(fields[4].c_str()) };
+    }
+    if (baseline.empty()) {
+        std::cerr << "No baseline results in " << path << '\n';
+        return 1;
+    }
+
+    auto solved = [](const std::string& status) {
+        return status == "SAT" || status == "UNSAT" || status == "OPT";
+    };
+    unsigned regressions = 0;
+    std::map<std::string, std::pair<double, unsigned>> log_ratios;
+    std::cout << "\nsolver instance baseline now ratio\n";
+    for (auto& a : results) {
+        auto found = baseline.find({ a.solver, a.instance });
+        if (found == baseline.end())
+            continue;
+        const std::string& old_status = found->second.first;
+        double old_seconds = found->second.second;
+        double ratio = a.wall_seconds / std::max(old_seconds, 1e-6);
+        std::string verdict;
+        if (solved(old_status) && (!solved(a.status) || a.status != old_status)) {
+            verdict = "REGRESSION " + old_status + " -> " + a.status;
+        } else if (solved(a.status) && std::max(old_seconds, a.wall_seconds)
+                >= min_seconds) {
+            if (ratio > 1 + tolerance)
+                verdict = "REGRESSION";
+            else if (ratio < 1 / (1 + tolerance))
+                verdict = "improved";
+            if (solved(old_status)) {
+                log_ratios[a.solver].first += std::log(ratio);
+                log_ratios[a.solver].second++;
+            }
+        }
+        if (verdict.compare(0, 10, "REGRESSION") == 0)
+            regressions++;
+        if (!verdict.empty())
+            std::cout << a.solver << ' ' << a.instance << ' ' << old_seconds
+                      << ' ' << a.wall_seconds << ' ' << ratio << ' '
+                      << verdict << '\n';
+    }
+    for (auto& a : log_ratios)
+        std::cout << a.first << ": geometric mean time ratio "
+                  << std::exp(a.second.first / a.second.second) << " over "
+                  << a.second.second << " instances\n";
+    std::cout << regressions << " regression(s)\n";
+    return regressions;
+}
+
+int usage(const char* name) {
+    std::cerr << "Usage: " << name << " generate DIR [--seeds=N]\n"
+              << "       " << name << " run DIR [--sat=NAME=COMMAND]..."
+              << " [--maxsat=NAME=COMMAND]... [--timeout=SECONDS]"
+              << " [--repeat=N] [--csv=FILE] [--json=FILE]"
+              << " [--baseline=FILE] [--tolerance=FRACTION]\n"
+              << "Without solvers, runs ./cdcl, ./dpll, ./max-sat and"
+              << " ./inc-sat; '" << stats_placeholder
+              << "' in a command becomes a file for cdcl --stats.\n";
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3)
+        return usage(argv[0]);
+    std::string mode = argv[1];
+    std::string directory = argv[2];
+    unsigned no_of_seeds = 3;
+    std::vector<solver_t> solvers;
+    double timeout = 10;
+    unsigned repeat = 1;
+    std::string csv_file, json_file, baseline_file;
+    double tolerance = 0.1;
+    for (int i = 3; i < argc; i++) {
+        std::string option = argv[i];
+        size_t equals = option.find('=', option.find('=') + 1);
+        if (option.compare(0, 8, "--seeds=") == 0)
+            no_of_seeds = std::max(1, atoi(option.c_str() + 8));
+        else if ((option.compare(0, 6, "--sat=") == 0
+                || option.compare(0, 9, "--maxsat=") == 0)
+                && equals != std::string::npos) {
+            size_t begin = option.find('=') + 1;
+            solvers.push_back({ option.substr(begin, equals - begin),
+                    option.substr(equals + 1), option[2] == 'm' });
+        } else if (option.compare(0, 10, "--timeout=") == 0)
+            timeout = atof(option.c_str() + 10);
+        else if (option.compare(0, 9, "--repeat=") == 0)
+            repeat = std::max(1, atoi(option.c_str() + 9));
+        else if (option.compare(0, 6, "--csv=") == 0)
+            csv_file = option.substr(6);
+        else if (option.compare(0, 7, "--json=") == 0)
+            json_file = option.substr(7);
+        else if (option.compare(0, 11, "--baseline=") == 0)
+            baseline_file = option.substr(11);
+        else if (option.compare(0, 12, "--tolerance=") == 0)
+            tolerance = atof(option.c_str() + 12);
+        else
+            return usage(argv[0]);
+    }
+
+    if (mode == "generate") {
+        if (!generate_suite(directory, no_of_seeds)) {
+            std::cerr << "Could not write the suite to " << directory << '\n';
+            return 1;
+        }
+        return 0;
+    }
+    if (mode != "run")
+        return usage(argv[0]);
+    if (solvers.empty())
+        solvers = { { "cdcl", "./cdcl --stats=" + stats_placeholder, false },
+                { "dpll", "./dpll", false },
+                { "max-sat", "./max-sat", true },
+                { "inc-sat", "./inc-sat", true } };
+
+    std::vector<std::string> instances = list_instances(directory);
+    if (instances.empty()) {
+        std::cerr << "No .cnf instances in " << directory << '\n';
+        return 1;
+    }
+    std::vector<run_result_t> results;
+    for (auto& name : instances) {
+        std::string path = directory + "/" + name;
+        std::string family = name.substr(0, name.find('.'));
+        bool maxsat = family.compare(0, 6, "maxsat") == 0;
+        dimacs_instance_t formula;
+        if (!read_dimacs(path.c_str(), formula)) {
+            std::cerr << "Could not read " << path << '\n';
+            return 1;
+        }
+        for (auto& solver : solvers) {
+            if (solver.maxsat != maxsat)
+                continue;
+            //  Of repeated runs the one of median wall time is kept.
+            std::vector<run_result_t> runs;
+            for (unsigned i = 0; i < repeat; i++)
+                runs.push_back(run_once(solver, path, formula, timeout));
+            std::sort(runs.begin(), runs.end(),
+                      [](const run_result_t& a, const run_result_t& b) {
+                          return a.wall_seconds < b.wall_seconds;
+                      });
+            run_result_t result = runs[runs.size() / 2];
+            result.solver = solver.name;
+            result.instance = name;
+            result.family = family;
+            std::cout << solver.name << ' ' << name << ' ' << result.status
+                      << ' ' << result.wall_seconds << "s "
+                      << result.peak_rss_kb << "KB" << std::endl;
+            results.push_back(result);
+        }
+    }
+    cross_check(results);
+
+    if (!csv_file.empty()) {
+        std::ofstream out(csv_file);
+        write_csv(out, results);
+    }
+    if (!json_file.empty()) {
+        std::ofstream out(json_file);
+        write_json(out, results);
+    }
+    unsigned wrong = 0;
+    for (auto& a : results)
+        if (a.status == "WRONG")
+            wrong++;
+    if (wrong)
+        std::cout << wrong << " wrong answer(s)\n";
+    unsigned regressions = 0;
+    if (!baseline_file.empty())
+        regressions = diff_baseline(results, baseline_file, tolerance, 0.05);
+    return wrong || regressions ? 2 : 0;
+}
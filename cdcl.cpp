@@ -3,565 +3,548 @@
 // Author      : Akash Banerjee (CS18MTECH11023@iith.ac.in)
 // Description : DPLL Sat Solver in C++11, Ansi-style
 //               Input  a  sat  instance  in  the  simplified  DIMACS  format
-//               through stdin  and  output either UNSAT or SAT followed by a
-//               satisfying  assignment on  the next line in  minisat2 format.
+//               through stdin, or the file named on the command line,  and
+//               output either UNSAT or SAT followed by a satisfying
+//               assignment on  the next line in  minisat2 format.
+//               With --threads=N a portfolio of N differently tuned solvers
+//               races on the instance, sharing short learnt clauses; with
+//               --cubes=M as well, the N solvers instead split the work of
+//               some M cubes produced by a lookahead (cube-and-conquer).
+//               With --proof=FILE a single solver logs a binary DRAT proof
+//               that an UNSAT answer can be checked with.
 //============================================================================
 
+// Compile with '-pthread' for the portfolio and cube modes.
+
+#include <atomic>
+#include <deque>
 #include <iostream>
 #include <limits>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <bits/stdc++.h>
 
-static int* variable_assignments;
-static int* variable_decision_level;
-static double* variable_priority;
-
-static double decay_factor = 0.5;
-
-static unsigned no_of_variables;
-static unsigned no_of_clauses;
-
-static unsigned random_restart_conflicts;
-static unsigned random_restart_threshold = 500;
-
-class clause_t {
-    std::unique_ptr<std::vector<int>> my_clause;
-    std::vector<int>::iterator wl1;
-    std::vector<int>::iterator wl2;
-
- public:
-    clause_t()
-            : my_clause { new std::vector<int>(0) } {
-    }
-
-    int& operator[](const unsigned index) {
-        return (*my_clause)[index];
-    }
-
-    int is_unit() {
-        int unassigned_count = 0, unassigned_literal = 0;
-        for (auto a : *my_clause) {
-            if (variable_assignments[abs(a)] == 0) {
-//                std::cout << "in 1 checking assignment of : " << abs(a) << '\n';
-                unassigned_count++;
-                unassigned_literal = a;
-            } else if (variable_assignments[abs(a)] == a) {
-//                std::cout << "in 3 checking assignment of : " << abs(a)
-//                          << " and comparing with" << a << '\n';
-                return 0;
-            }
-            if (unassigned_count > 1)
-                return 0;
-        }
-        if (unassigned_count == 1)
-            return unassigned_literal;
-        return 0;
-    }
-
-    bool is_unsatisfiable() {
-        for (auto a : *my_clause) {
-            if (variable_assignments[abs(a)] == a
-                    || variable_assignments[abs(a)] == 0) {
-                return false;
-            }
-        }
+#include "cdcl.h"
+#include "cube_pool.h"
+#include "dimacs.h"
+#include "drat.h"
+#include "preprocess.h"
+
+// Named input files are cached as "<file>.cnfbin" so that later runs map
+// the parsed instance instead of tokenizing the text again.
+static bool use_instance_cache = true;
+// SatELite style simplification before search; it keeps what is needed to
+// assign the variables it eliminates once a model is found.
+static bool preprocessing = true;
+// Wall clock seconds load_formula spent reading and simplifying the input,
+// reported with --stats.
+static double parse_seconds = 0;
+static double preprocess_seconds = 0;
+// With --stats the counters of the search are written out as JSON at the
+// end, to statistics_file or, if that is empty, to stderr.
+static bool print_statistics = false;
+static std::string statistics_file;
+// Where to write a DRAT proof, empty for none.  The preprocessor does not
+// log its steps, so it is turned off when a proof is asked for.
+static std::string proof_file;
+
+//  Cube-and-conquer: the lookahead gives up splitting once it has visited
+//  lookahead_effort clause literals, and a worker splits any cube it has
+//  not decided within cube_conflict_limit conflicts in two.
+static const unsigned long lookahead_effort = 200000000;
+static const unsigned cube_conflict_limit = 2000;
+
+//Input :   Path of the DIMACS input, nullptr for stdin.
+//
+//Output:   Read the instance into formula, simplified by a new
+//          preprocessor unless preprocessing is off; the variables it
+//          eliminated are to be kept out of the search.  Returns false
+//          if the instance could not be read.
+bool load_formula(const char* path, dimacs_instance_t& formula,
+                  std::unique_ptr<preprocessor_t>& preprocessor) {
+    auto start = std::chrono::steady_clock::now();
+    if (!read_dimacs(path, formula, use_instance_cache))
+        return false;
+    parse_seconds = seconds_since(start);
+    if (!preprocessing)
         return true;
-    }
-
-    void push_back(const int literal) {
-        my_clause->push_back(literal);
-    }
-
-    std::vector<int>::iterator erase(std::vector<int>::iterator it) {
-        return my_clause->erase(it);
-    }
-
-    std::vector<int>::iterator erase(std::vector<int>::iterator it1,
-                                     std::vector<int>::iterator it2) {
-        return my_clause->erase(it1, it2);
-    }
-
-    std::vector<int>::iterator begin() {
-        return my_clause->begin();
-    }
-
-    std::vector<int>::iterator end() {
-        return my_clause->end();
-    }
-
-    std::vector<int>::iterator watch_lit_1() {
-        return wl1;
-    }
-
-    std::vector<int>::iterator watch_lit_2() {
-        return wl2;
-    }
-
-    std::vector<int>::iterator set_watch_lit_1() {
-        std::vector<int>::iterator temp = my_clause->end();
-        for (std::vector<int>::iterator i = my_clause->begin();
-                i < my_clause->end(); i++) {
-//            std::cout << "atleast entered ... \n";
-            if (variable_assignments[abs(*i)] == 0 && wl2 != i) {
-                temp = i;
-            }
-//            std::cout << "yolo --- " << *i << '\n';
-            if (variable_assignments[abs(*i)] == *i) {
-                wl1 = i;
-                return wl1;
+    start = std::chrono::steady_clock::now();
+    preprocessor.reset(new preprocessor_t(formula.no_of_variables));
+
+    std::vector<char> seen(formula.no_of_variables + 1);
+    std::vector<int> clause;
+    for (unsigned i = 0; i < formula.no_of_clauses; i++) {
+        clause.clear();
+        bool tautology = false;
+        for (const int* a = formula.begin(i); a != formula.end(i); a++) {
+            if (seen[abs(*a)] == 0) {
+                seen[abs(*a)] = *a > 0 ? 1 : 2;
+                clause.push_back(*a);
+            } else if (seen[abs(*a)] != (*a > 0 ? 1 : 2)) {
+                tautology = true;
             }
-//            std::cout << "here now\n";
         }
-        if (temp != my_clause->end())
-            wl1 = temp;
-        return wl1;
-    }
-
-    std::vector<int>::iterator set_watch_lit_2() {
-        std::vector<int>::iterator temp = my_clause->end();
-        for (std::vector<int>::iterator i = my_clause->end() - 1;
-                i >= my_clause->begin(); i--) {
-            if (variable_assignments[abs(*i)] == 0 && wl1 != i) {
-                temp = i;
-            }
-            if (variable_assignments[abs(*i)] == *i) {
-                wl2 = i;
-                return wl2;
-            }
-        }
-        if (temp != my_clause->end())
-            wl2 = temp;
-        return wl2;
-    }
-
-    void set_watch_lit_1(std::vector<int>::iterator it) {
-        wl1 = it;
-    }
-
-    void set_watch_lit_2(std::vector<int>::iterator it) {
-        wl2 = it;
-    }
-
-};
-
-static std::shared_ptr<clause_t> null_clause;
-typedef std::list<std::shared_ptr<clause_t>> sat_instance_t;
-static sat_instance_t sat_instance;
-//std::unique_ptr<std::vector<std::shared_ptr<clause_t>>> variables;
-static std::set<std::shared_ptr<clause_t>> *variables;
-static std::vector<std::shared_ptr<clause_t>> variable_antecedent;
-
-static unsigned no_of_variables_assigned;
-
-inline bool absolute_comparator(int i, int j) {
-    return abs(i) < abs(j);
+        for (auto a : clause)
+            seen[abs(a)] = 0;
+        if (!tautology)
+            preprocessor->add_clause(clause);
+    }
+
+    dimacs_instance_t simplified;
+    simplified.no_of_variables = formula.no_of_variables;
+    auto add = [&simplified](const std::vector<int>& clause) {
+        simplified.literals.insert(simplified.literals.end(), clause.begin(),
+                                   clause.end());
+        simplified.clause_offsets.push_back(simplified.literals.size());
+        simplified.no_of_clauses++;
+    };
+    if (preprocessor->simplify())
+        preprocessor->for_each_clause(add);
+    else
+        add(std::vector<int>());
+    preprocessor->drop_formula();
+    formula = std::move(simplified);
+    preprocess_seconds = seconds_since(start);
+    return true;
 }
 
-void print_status() {
-//    for (auto &a : sat_instance) {
-//        for (auto i : *a) {
-//            std::cout << i << ' ';
-//        }
-//        std::cout << '\n';
-//        std::cout << "watch 1 : " << *(*a).watch_lit_1() << '\n';
-//        std::cout << "watch 2 : " << *(*a).watch_lit_2() << '\n';
-//        std::cout << "Unit Status : " << (*a).is_unit() << '\n';
-//    }
+//Input :   The options given and a worker no.
 //
-//    std::cout << "Printing Variables:\n\n";
-//    for (unsigned i = 1; i <= no_of_variables; i++) {
-//        for (auto& a : variables[i]) {
-//            std::cout << i << "in clause: ";
-//            for (auto b : *a)
-//                std::cout << b << ' ';
-//            std::cout << '\n';
-//        }
-//        std::cout << '\n';
-//    }
-
-    std::cout << "Printing Variable antecedents:\n\n";
-    for (unsigned i = 1; i <= no_of_variables; i++) {
-        std::cout << i << " Antecedent clause: ";
-        if (variable_antecedent[i] != null_clause)
-            for (auto b : *variable_antecedent[i])
-                std::cout << b << ' ';
-        std::cout << '\n';
-    }
-
-    std::cout << "Printing Variable Assignments:\n\n";
-    for (unsigned i = 1; i <= no_of_variables; i++) {
-        std::cout << variable_assignments[i] << ' '
-                  << variable_decision_level[i] << '\n';
-    }
-    std::cout << '\n';
+//Output:   Options for that portfolio worker: worker 0 runs the given
+//          ones, the others cycle through restart policies, rephasing,
+//          polarities and seeds so that no two search alike.
+cdcl_options_t worker_options(const cdcl_options_t& options, unsigned worker) {
+    static const char* restarts[] = { "glucose", "luby", "glucose", "fixed" };
+    cdcl_options_t tuned = options;
+    if (worker == 0)
+        return tuned;
+    tuned.restart = restarts[worker % 4];
+    tuned.restart_blocking = worker % 3 != 2;
+    tuned.rephasing = worker % 2 == 1;
+    tuned.inverted_phase = (worker >> 1) % 2 == 1;
+    tuned.seed = worker;
+    return tuned;
 }
 
-void initialize_sat_instance() {
-    char a;
-    std::cin >> a;
-    while (a != 'p') {
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::cin >> a;
-    }
-
-    std::cin.ignore(5);
-    std::cin >> no_of_variables;
-    std::cin >> no_of_clauses;
-    variables = new std::set<std::shared_ptr<clause_t>>[no_of_variables + 1];
-    variable_antecedent = std::vector<std::shared_ptr<clause_t>>(
-            no_of_variables + 1);
-    variable_assignments = (int*) calloc((no_of_variables + 1), sizeof(int));
-    variable_decision_level = (int*) calloc((no_of_variables + 1), sizeof(int));
-    variable_priority = (double*) calloc(((no_of_variables << 1) + 2),
-                                         sizeof(double));
-
-    for (unsigned i = 1; i <= no_of_variables; i++) {
-        variable_decision_level[i] = -1;
-        variable_antecedent[i] = null_clause;
-    }
-
-    for (unsigned i = 0; i < no_of_clauses; i++) {
-        int literal;
-        std::shared_ptr<clause_t> clause { new clause_t };
-        std::cin.ignore(10, '\n');
-        while (true) {
-            std::cin >> literal;
-            if (!std::cin.good()) {
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
-                                '\n');
-                continue;
-            }
-            if (literal == 0)
-                break;
-            clause->push_back(literal);
-        }
-        clause->set_watch_lit_1(clause->begin());
-        clause->set_watch_lit_2(clause->end() - 1);
-        variables[abs(*(clause->watch_lit_1()))].insert(clause);
-        variables[abs(*(clause->watch_lit_2()))].insert(clause);
-        sat_instance.push_back(clause);
-    }
+//Input :   The formula, the options, no. of workers and the variables
+//          eliminated from the formula.
+//
+//Output:   Race that many solvers on the formula, one per thread.  The
+//          first to reach an answer stops the rest; its answer is returned
+//          and, if SAT, its model copied into model.  The statistics of all
+//          the workers are added into statistics.
+result_t solve_portfolio(const dimacs_instance_t& formula,
+                         const cdcl_options_t& options, unsigned no_of_workers,
+                         const std::vector<unsigned>& eliminated,
+                         std::vector<int>& model,
+                         cdcl_statistics_t& statistics) {
+    clause_exchange_t exchange(no_of_workers);
+    std::atomic<int> winner { -1 };
+    result_t result = result_unknown;
+    std::vector<cdcl_statistics_t> worker_statistics(no_of_workers);
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < no_of_workers; i++) {
+        threads.emplace_back([&, i]() {
+            cdcl_solver_t solver(formula, worker_options(options, i));
+            for (auto v : eliminated)
+                solver.set_eliminated(v);
+            solver.share_clauses(&exchange, i);
+            result_t answer = solver.solve();
+            worker_statistics[i] = solver.statistics();
+            int none = -1;
+            if (answer == result_unknown
+                    || !winner.compare_exchange_strong(none, (int) i))
+                return;
+            exchange.stop.store(true);
+            result = answer;
+            if (answer == result_sat)
+                model = solver.model();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& a : worker_statistics)
+        statistics += a;
+    return result;
 }
 
-bool assign_literal(int literal, std::vector<int>& unit_literals,
-                    std::vector<std::shared_ptr<clause_t>>& antecedants,
-                    std::shared_ptr<clause_t>& unsat_clause) {
-    variable_assignments[abs(literal)] = literal;
-    no_of_variables_assigned++;
-    int flag;
-//    std::cout << "Set Variable assignment for " << literal << '\n';
-    for (auto i = variables[abs(literal)].begin();
-            i != variables[abs(literal)].end();) {
-        flag = 0;
-//        std::cout << "Size = " << variables[abs(literal)].size() << '\n';
-//        std::cout << "Entered Loop\n";
-        if (abs(*((*i)->watch_lit_1())) == abs(literal)) {
-//            std::cout << "Attempting fix of watch literal 1  = "
-//                      << *((*i)->watch_lit_1()) << '\n';
-            (*i)->set_watch_lit_1();
-            if (abs(*((*i)->watch_lit_1())) != abs(literal)) {
-                flag = 1;
-                variables[abs(*((*i)->watch_lit_1()))].insert(*i);
-            }
-        } else if (abs(*((*i)->watch_lit_2())) == abs(literal)) {
-//            std::cout << "Attempting fix of watch literal 2  = "
-//                      << *((*i)->watch_lit_2()) << '\n';
-            (*i)->set_watch_lit_2();
-            if (abs(*((*i)->watch_lit_2())) != abs(literal)) {
-                flag = 1;
-                variables[abs(*((*i)->watch_lit_2()))].insert(*i);
+//  Splits the search space into cubes, conjunctions of literals that
+//  between them cover every model.  Like dpll's pick_literal each split is
+//  on the variable occurring most often in the shortest clauses left; a
+//  side whose unit propagation fails is dropped.
+class cube_generator_t {
+    const dimacs_instance_t& formula;
+    std::vector<std::vector<unsigned>> occurrences;
+    std::vector<int> assignments;
+    std::vector<int> trail;
+    std::vector<unsigned> variable_count;
+    unsigned long effort = 0;
+
+    //Input :   A literal.
+    //
+    //Output:   Make it true along with whatever unit propagation implies;
+    //          returns false if that falsifies a clause.
+    bool assign(int literal) {
+        if (assignments[abs(literal)] != 0)
+            return assignments[abs(literal)] == literal;
+        assignments[abs(literal)] = literal;
+        trail.push_back(literal);
+        for (size_t head = trail.size() - 1; head < trail.size(); head++) {
+            for (auto i : occurrences[watch_index(-trail[head])]) {
+                effort += formula.size(i);
+                int unassigned = 0, no_of_unassigned = 0;
+                bool satisfied = false;
+                for (const int* a = formula.begin(i); a != formula.end(i); a++) {
+                    if (assignments[abs(*a)] == *a) {
+                        satisfied = true;
+                        break;
+                    }
+                    if (assignments[abs(*a)] == 0) {
+                        unassigned = *a;
+                        no_of_unassigned++;
+                    }
+                }
+                if (satisfied)
+                    continue;
+                if (no_of_unassigned == 0)
+                    return false;
+                if (no_of_unassigned == 1) {
+                    assignments[abs(unassigned)] = unassigned;
+                    trail.push_back(unassigned);
+                }
             }
-        } else {
-//            std::cout << abs(*((*i)->watch_lit_1())) << "   "
-//                      << abs(*((*i)->watch_lit_2())) << "   " << abs(literal);
-            std::cout << "\n\n!!!Fatal Warning!!!\n\n";
-        }
-//        std::cout << "Checking for unsatisfiability\n";
-        if ((*i)->is_unsatisfiable()) {
-            unsat_clause = *i;
-            return false;
         }
-
-//        std::cout << "Checking for unit clause\n";
-        int a = (*i)->is_unit();
-        if (a) {
-//            std::cout << "Clause is unit so Pushing back " << a << '\n';
-            unit_literals.push_back(a);
-            antecedants.push_back(*i);
-        }
-        if (flag) {
-//            std::cout << abs(*((*i)->watch_lit_1())) << "   "
-//                      << abs(*((*i)->watch_lit_2())) << "   " << abs(literal);
-//            std::cout << "Removed reference from variable\n";
-            variables[abs(literal)].erase(i++);
-        } else
-            ++i;
-//        i--;
+        return true;
     }
-    return true;
-}
 
-bool unit_propagate(int decision_level,
-                    std::shared_ptr<clause_t>& unsat_clause) {
-    std::vector<int> unit_literals(0);
-    std::vector<std::shared_ptr<clause_t>> antecedants;
-    for (auto &a : sat_instance) {
-        if ((*a).is_unsatisfiable()) {
-            unsat_clause = a;
-            return false;
-        }
-        int unit_literal = (*a).is_unit();
-        if (unit_literal) {
-            if (decision_level > 0) {
-//                std::cout << "set variable antecedent for " << unit_literal
-//                          << '\n';
-                variable_antecedent[abs(unit_literal)] = a;
-            }
-            variable_decision_level[abs(unit_literal)] = decision_level;
-//            std::cout << "\n\n\nAttempting to remove in 1: " << unit_literal
-//                      << '\n';
-            if (!assign_literal(unit_literal, unit_literals, antecedants,
-                                unsat_clause))
-                return false;
+    void undo(size_t trail_size) {
+        while (trail.size() > trail_size) {
+            assignments[abs(trail.back())] = 0;
+            trail.pop_back();
         }
     }
-    while (!unit_literals.empty()) {
-        int unit_literal = unit_literals.back();
-        unit_literals.pop_back();
 
-        if (decision_level > 0) {
-//            std::cout << "set variable antecedent for " << unit_literal << '\n';
-            variable_antecedent[abs(unit_literal)] = antecedants.back();
+    //Output:   The most occurring unassigned variable in the minimum sized
+    //          clauses not yet satisfied, 0 if all of them are.
+    unsigned pick_variable() {
+        effort += formula.no_of_literals();
+        unsigned min_clause_size = std::numeric_limits<unsigned>::max();
+        std::vector<unsigned> min_clauses;
+        for (unsigned i = 0; i < formula.no_of_clauses; i++) {
+            unsigned size = 0;
+            for (const int* a = formula.begin(i); a != formula.end(i); a++) {
+                if (assignments[abs(*a)] == *a) {
+                    size = 0;
+                    break;
+                }
+                if (assignments[abs(*a)] == 0)
+                    size++;
+            }
+            if (size == 0 || size > min_clause_size)
+                continue;
+            if (size < min_clause_size) {
+                min_clause_size = size;
+                min_clauses.clear();
+            }
+            min_clauses.push_back(i);
         }
-        variable_decision_level[abs(unit_literal)] = decision_level;
-        antecedants.pop_back();
-//        std::cout << "\n\n\nAttempting to remove in 2: " << unit_literal
-//                  << '\n';
-        if (!assign_literal(unit_literal, unit_literals, antecedants,
-                            unsat_clause))
-            return false;
-    }
-    return true;
-}
 
-bool all_variables_assigned() {
-    for (unsigned i = 1; i <= no_of_variables; i++) {
-        if (variable_assignments[i] == 0) {
-            return false;
+        unsigned max_occurrence = 0;
+        unsigned max_occurring_variable = 0;
+        for (auto i : min_clauses) {
+            for (const int* a = formula.begin(i); a != formula.end(i); a++) {
+                unsigned variable = abs(*a);
+                if (assignments[variable] == 0
+                        && ++variable_count[variable] > max_occurrence) {
+                    max_occurrence = variable_count[variable];
+                    max_occurring_variable = variable;
+                }
+            }
         }
-    }
-    return true;
-//    return no_of_variables_assigned == no_of_variables ? true : false;
-}
-
-int pick_literal() {
-    int literal = no_of_variables;
-    for (int i = 0; i < (int) (no_of_variables << 1) + 1; i++) {
-        variable_priority[i] *= decay_factor;
-//        std::cout << i-(int)no_of_variables << ' ' << variable_priority[i] << '\n';
-    }
-//    std::cout << '\n';
-    for (int i = 0; i < (int) (no_of_variables << 1) + 1; i++) {
-//        std::cout << i << '\t' << abs(i - (int) no_of_variables) << '\t'
-//                  << variable_priority[i] << '\t'
-//                  << variable_assignments[abs(i - (int) no_of_variables)]
-//                  << '\n';
-        if (variable_priority[i] >= variable_priority[literal]
-                && variable_assignments[abs(i - (int) no_of_variables)] == 0) {
-            literal = i;
+        for (auto i : min_clauses)
+            for (const int* a = formula.begin(i); a != formula.end(i); a++)
+                variable_count[abs(*a)] = 0;
+        return max_occurring_variable;
+    }
+
+    void split(std::vector<int>& cube, unsigned depth,
+               std::vector<std::vector<int>>& cubes) {
+        unsigned variable = depth > 0 && effort < lookahead_effort ?
+                pick_variable() : 0;
+        if (!variable) {
+            cubes.push_back(cube);
+            return;
         }
-    }
-//    std::cout << "returning " << literal - (int) no_of_variables << '\n';
-    return literal - (int) no_of_variables;
-}
-
-bool resolution(std::shared_ptr<clause_t> clause1,
-                std::shared_ptr<clause_t> clause2, int resolution_literal) {
-//    std::cout << "Resolution literal : " << resolution_literal << '\n';
-//    std::cout << "performing resolution for clauses: \n";
-//    std::cout << "clause 1: ";
-//    for (auto a : *clause1) {
-//        std::cout << a << ' ';
-//    }
-//    std::cout << '\n';
-//    std::cout << "clause 2: ";
-//    for (auto a : *clause2) {
-//        std::cout << a << ' ';
-//    }
-//    std::cout << '\n';
-    clause1->erase(
-            std::find(clause1->begin(), clause1->end(), resolution_literal));
-    for (auto a : *clause2) {
-        if (a != -resolution_literal
-                && std::find(clause1->begin(), clause1->end(), a)
-                        == clause1->end()) {
-            clause1->push_back(a);
+        size_t trail_size = trail.size();
+        for (int literal : { static_cast<int>(variable),
+                -static_cast<int>(variable) }) {
+            if (assign(literal)) {
+                cube.push_back(literal);
+                split(cube, depth - 1, cubes);
+                cube.pop_back();
+            }
+            undo(trail_size);
         }
     }
-//    std::cout << "After resolution clause 1: ";
-//    for (auto a : *clause1) {
-//        std::cout << a << ' ';
-//    }
-//    std::cout << '\n';
-    return false;
-}
 
-bool uip_clause(int decision_level, std::shared_ptr<clause_t> clause) {
-    unsigned current_level__literals_count = 0;
-    for (auto a : *clause) {
-        if (variable_decision_level[abs(a)] == decision_level) {
-            current_level__literals_count++;
-            if (current_level__literals_count > 1)
-                return false;
+ public:
+    explicit cube_generator_t(const dimacs_instance_t& formula)
+            : formula(formula),
+              occurrences((formula.no_of_variables << 1) + 2),
+              assignments(formula.no_of_variables + 1),
+              variable_count(formula.no_of_variables + 1) {
+        for (unsigned i = 0; i < formula.no_of_clauses; i++)
+            for (const int* a = formula.begin(i); a != formula.end(i); a++)
+                occurrences[watch_index(*a)].push_back(i);
+    }
+
+    //Input :   The no. of cubes wanted, and a reference to return them in.
+    //
+    //Output:   Split up to log2 of that many times along every branch, fewer
+    //          once the lookahead effort is spent.  No cube at all means
+    //          the formula is unsatisfiable.
+    void generate(unsigned no_of_cubes, std::vector<std::vector<int>>& cubes) {
+        unsigned depth = 0;
+        while ((1ul << depth) < no_of_cubes)
+            depth++;
+        for (unsigned i = 0; i < formula.no_of_clauses; i++) {
+            if (formula.size(i) == 0)
+                return;
+            if (formula.size(i) == 1 && !assign(formula.begin(i)[0]))
+                return;
         }
+        std::vector<int> cube;
+        split(cube, depth, cubes);
     }
-    if (current_level__literals_count == 1)
-        return true;
-    return false;
-}
-
-int conflict_analysis(int decision_level,
-                      std::shared_ptr<clause_t> unsat_clause) {
-    random_restart_conflicts++;
-    std::shared_ptr<clause_t> learnt_clause { new clause_t };
+};
 
-    for (auto a : *unsat_clause) {
-        learnt_clause->push_back(a);
-    }
-    std::set<int> resolved_variables;
-    int flag = 1;
-    while (flag) {
-        flag = 0;
-        for (auto a = learnt_clause->begin(); a < learnt_clause->end(); a++) {
-            if (variable_antecedent[abs(*a)] != null_clause
-                    && (resolved_variables.find(*a) == resolved_variables.end())) {
-                flag = 1;
-                resolved_variables.insert(*a);
-                resolution(learnt_clause, variable_antecedent[abs(*a)], *a);
-                if (uip_clause(decision_level, learnt_clause)) {
-                    flag = 0;
+//Input :   The formula, the options, no. of workers, no. of cubes to start
+//          with and the variables eliminated from the formula.
+//
+//Output:   Cube-and-conquer: cut the formula into cubes and let that many
+//          solvers, one per thread, work through them under assumptions,
+//          keeping their learnt clauses from cube to cube and sharing the
+//          short ones.  Returns result_sat, with the model copied into
+//          model, as soon as one cube has a model, and result_unsat once
+//          none has.  The statistics of all the workers are added into
+//          statistics.
+result_t solve_cubes(const dimacs_instance_t& formula,
+                     const cdcl_options_t& options, unsigned no_of_workers,
+                     unsigned no_of_cubes,
+                     const std::vector<unsigned>& eliminated,
+                     std::vector<int>& model,
+                     cdcl_statistics_t& statistics) {
+    std::vector<std::vector<int>> cubes;
+    cube_generator_t(formula).generate(no_of_cubes, cubes);
+    cube_pool_t pool(no_of_workers);
+    for (size_t i = 0; i < cubes.size(); i++)
+        pool.push(static_cast<unsigned>(i * no_of_workers / cubes.size()),
+                  std::move(cubes[i]));
+
+    clause_exchange_t exchange(no_of_workers);
+    std::atomic<int> winner { -1 };
+    result_t result = result_unsat;
+    std::vector<cdcl_statistics_t> worker_statistics(no_of_workers);
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < no_of_workers; i++) {
+        threads.emplace_back([&, i]() {
+            cdcl_solver_t solver(formula, options);
+            for (auto v : eliminated)
+                solver.set_eliminated(v);
+            solver.share_clauses(&exchange, i);
+            std::vector<int> cube;
+            while (pool.take(i, cube, exchange.stop)) {
+                result_t answer = solver.solve(cube, cube_conflict_limit);
+                if (answer == result_unknown && !exchange.stop.load()) {
+                    unsigned variable = solver.branch_variable(cube);
+                    if (variable) {
+                        cube.push_back(static_cast<int>(variable));
+                        pool.push(i, cube);
+                        cube.back() = -cube.back();
+                        pool.push(i, cube);
+                        pool.finish();
+                        continue;
+                    }
+                    //  Nothing left to split on: settle the cube here, or
+                    //  the pool would wait for it forever.
+                    answer = solver.solve(cube);
+                }
+                if (answer == result_unknown)
                     break;
+                if (answer == result_unsat && !solver.proved_unsat()) {
+                    pool.finish();
+                    continue;
+                }
+                int none = -1;
+                if (winner.compare_exchange_strong(none, (int) i)) {
+                    result = answer;
+                    if (answer == result_sat)
+                        model = solver.model();
                 }
-                a = learnt_clause->begin();
+                exchange.stop.store(true);
+                break;
             }
-        }
-    }
-    int backtrack_level = 0;
-    for (auto a : *learnt_clause) {
-        variable_priority[a + no_of_variables]++;
-        if (variable_decision_level[abs(a)] > backtrack_level
-                && variable_decision_level[abs(a)] < decision_level)
-            backtrack_level = variable_decision_level[abs(a)];
-    }
-    learnt_clause->set_watch_lit_1(learnt_clause->begin());
-    learnt_clause->set_watch_lit_2(learnt_clause->end() - 1);
-    variables[abs(*(learnt_clause->watch_lit_1()))].insert(learnt_clause);
-    variables[abs(*(learnt_clause->watch_lit_2()))].insert(learnt_clause);
-    sat_instance.push_back(learnt_clause);
-//    if(backtrack_level > 0)
-//        return backtrack_level-1;
-    return backtrack_level;
+            worker_statistics[i] = solver.statistics();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& a : worker_statistics)
+        statistics += a;
+    return result;
 }
 
-void backtrack(int backtrack_level) {
-    for (unsigned i = 1; i <= no_of_variables; i++) {
-        if (variable_decision_level[i] > backtrack_level) {
-            variable_assignments[i] = 0;
-            no_of_variables_assigned--;
-            variable_decision_level[i] = -1;
-            variable_antecedent[i] = null_clause;
-        }
+//Input :   Command line options.
+//
+//Output:   Fill in the solver options, no. of threads and no. of cubes, 0
+//          for no cube-and-conquer, and set path to the input file if one
+//          is given; returns false on an unknown option.
+bool parse_options(int argc, char* argv[], const char*& path,
+                   cdcl_options_t& options, unsigned& no_of_threads,
+                   unsigned& no_of_cubes) {
+    path = nullptr;
+    no_of_threads = 1;
+    no_of_cubes = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option[0] != '-' && !path)
+            path = argv[i];
+        else if (option.compare(0, 10, "--restart=") == 0)
+            options.restart = option.substr(10);
+        else if (option == "--no-restart-blocking")
+            options.restart_blocking = false;
+        else if (option == "--rephase")
+            options.rephasing = true;
+        else if (option == "--no-cache")
+            use_instance_cache = false;
+        else if (option == "--no-preprocess")
+            preprocessing = false;
+        else if (option.compare(0, 10, "--threads=") == 0)
+            no_of_threads = std::max(1, atoi(option.c_str() + 10));
+        else if (option.compare(0, 8, "--cubes=") == 0)
+            no_of_cubes = std::max(1, atoi(option.c_str() + 8));
+        else if (option == "--progress")
+            options.progress_interval = 1;
+        else if (option.compare(0, 11, "--progress=") == 0)
+            options.progress_interval = atof(option.c_str() + 11);
+        else if (option == "--stats")
+            print_statistics = true;
+        else if (option.compare(0, 8, "--stats=") == 0) {
+            print_statistics = true;
+            statistics_file = option.substr(8);
+        } else if (option.compare(0, 8, "--proof=") == 0 && option.size() > 8)
+            proof_file = option.substr(8);
+        else
+            return false;
     }
-}
-
-bool cdcl() {
-    int decision_level = 0;
-    std::shared_ptr<clause_t> unsat_clause;
-    if (!unit_propagate(decision_level, unsat_clause)) {
+    //  Clauses imported from other workers would be missing from the proof.
+    if (!proof_file.empty() && (no_of_threads > 1 || no_of_cubes))
         return false;
-    }
-    int flag = 1;
-    while (!all_variables_assigned()) {
-        if (flag) {
-            int literal = pick_literal();
-//            std::cout
-//                    << "\n\n000000000000000000000000000000000000000000000000000000\n\nPicked Literal : "
-//                    << literal << '\n';
-            decision_level++;
-            std::vector<std::shared_ptr<clause_t>> dummy_antecedants;
-            std::vector<int> dummy_unit_literals;
-            variable_decision_level[abs(literal)] = decision_level;
-            if (!assign_literal(literal, dummy_unit_literals, dummy_antecedants,
-                                unsat_clause)) {
-//                std::cout
-//                        << "!!!Decision assignment caused Conflict!!!\nEither unit_propagation or assign_literal is broken!\n\n";
-            }
-//            std::cout
-//                    << "\n\n\n\n\nAssignment completed now unit propagating!!!!\n\n";
-        }
-        flag = 1;
-        if (!unit_propagate(decision_level, unsat_clause)) {
-            flag = 0;
-//            std::cout
-//                    << "===============\n\n===============\n\nUnit Propagation reproted conflict!\n\n";
-            int backtrack_level = conflict_analysis(decision_level,
-                                                    unsat_clause);
-            if (backtrack_level < 0) {
-//                std::cout
-//                        << "+++++++++++++++++++++++++++++++\n\nBacktrack level < 0\nReturning UNSAT!!\n+++++++++++++++++++++++++++++\n";
-                return false;
-            }
-//            std::cout << "Backtracking to " << backtrack_level << '\n';
-//            std::cout << "\n\nPrinting Status! Before back track\n";
-//            std::cout
-//                    << "\n-------------------------------------------------------------------------------------------------\n";
-//            print_status();
-//            std::cout
-//                    << "\n-------------------------------------------------------------------------------------------------\n\n";
-            backtrack(backtrack_level);
-            decision_level = backtrack_level;
-            if(random_restart_conflicts > random_restart_threshold){
-//                std::cout << "restarted!\n";
-                random_restart_conflicts = 0;
-//                std::cout << "restarted!" << random_restart_conflicts << '\n';
-                backtrack_level = 0;
-                backtrack(0);
-            }
-//            std::cout << "\n\nAfter back trackPrinting Status!\n";
-//            std::cout
-//                    << "\n-------------------------------------------------------------------------------------------------\n";
-//            print_status();
-//            std::cout
-//                    << "\n-------------------------------------------------------------------------------------------------\n\n";
-        }
-    }
-    return true;
+    return std::unique_ptr<restart_policy_t>(make_restart_policy(options))
+            != nullptr;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     auto start_time = std::chrono::high_resolution_clock::now();
-    initialize_sat_instance();
-//    print_status();
-    if (cdcl()) {
+    const char* path;
+    cdcl_options_t options;
+    unsigned no_of_threads, no_of_cubes;
+    if (!parse_options(argc, argv, path, options, no_of_threads, no_of_cubes)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--restart=fixed|luby|glucose] [--no-restart-blocking]"
+                  << " [--rephase] [--no-cache] [--no-preprocess]"
+                  << " [--threads=N] [--cubes=M] [--progress[=SECONDS]]"
+                  << " [--stats[=FILE]] [--proof=FILE] [instance.cnf]\n";
+        return 1;
+    }
+    std::unique_ptr<drat_writer_t> proof;
+    if (!proof_file.empty()) {
+        proof.reset(new drat_writer_t(proof_file.c_str()));
+        if (!proof->good()) {
+            std::cerr << "Could not open " << proof_file << '\n';
+            return 1;
+        }
+        preprocessing = false;
+    }
+    dimacs_instance_t formula;
+    std::unique_ptr<preprocessor_t> preprocessor;
+    if (!load_formula(path, formula, preprocessor)) {
+        std::cerr << "Could not read a DIMACS instance from "
+                  << (path ? path : "stdin") << '\n';
+        return 1;
+    }
+    unsigned no_of_variables = formula.no_of_variables;
+    unsigned no_of_clauses = formula.no_of_clauses;
+    std::vector<unsigned> eliminated;
+    for (unsigned i = 1; preprocessor && i <= no_of_variables; i++)
+        if (preprocessor->is_eliminated(i))
+            eliminated.push_back(i);
+
+    std::vector<int> model;
+    result_t result;
+    cdcl_statistics_t statistics;
+    if (no_of_cubes) {
+        result = solve_cubes(formula, options, no_of_threads, no_of_cubes,
+                             eliminated, model, statistics);
+    } else if (no_of_threads == 1) {
+        cdcl_solver_t solver(formula, options);
+        formula = dimacs_instance_t();
+        for (auto v : eliminated)
+            solver.set_eliminated(v);
+        solver.write_proof(proof.get());
+        result = solver.solve();
+        if (result == result_sat)
+            model = solver.model();
+        statistics = solver.statistics();
+    } else {
+        result = solve_portfolio(formula, options, no_of_threads, eliminated,
+                                 model, statistics);
+    }
+
+    if (proof && !proof->close_proof()) {
+        std::cerr << "Could not write the proof to " << proof_file << '\n';
+        return 1;
+    }
+
+    if (result == result_sat) {
+        if (preprocessor)
+            preprocessor->extend_model(model.data());
         std::cout << "SAT\n";
         for (unsigned i = 1; i <= no_of_variables; i++)
-            std::cout << variable_assignments[i] << ' ';
+            std::cout << model[i] << ' ';
         std::cout << '0';
     } else
         std::cout << "UNSAT";
 
-//    std::cout << "\n\n";
-//    print_status();
-    delete[] variables;
-    free(variable_assignments);
-    free(variable_decision_level);
-    free(variable_priority);
-
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
             end_time - start_time);
     std::cout << "\nTime Taken: ";
     std::cout << duration.count() << std::endl;
+
+    if (print_statistics) {
+        std::ofstream file;
+        if (!statistics_file.empty())
+            file.open(statistics_file);
+        std::ostream& out = statistics_file.empty() ? std::cerr : file;
+        out << "{\"result\": \"" << (result == result_sat ? "SAT" : "UNSAT")
+            << "\", \"threads\": " << no_of_threads
+            << ", \"cubes\": " << no_of_cubes
+            << ", \"variables\": " << no_of_variables
+            << ", \"clauses\": " << no_of_clauses
+            << ", \"eliminated_variables\": " << eliminated.size()
+            << ", \"parse_seconds\": " << parse_seconds
+            << ", \"preprocess_seconds\": " << preprocess_seconds
+            << ", \"total_seconds\": " << duration.count() / 1000.0
+            << ", \"search\": ";
+        statistics.write_json(out);
+        out << "}\n";
+        if (!out) {
+            std::cerr << "Could not write statistics to " << statistics_file
+                      << '\n';
+            return 1;
+        }
+    }
     return 0;
 }
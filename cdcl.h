@@ -0,0 +1,1720 @@
+//============================================================================
+// Name        : cdcl.h
+// Author      : Akash Banerjee (CS18MTECH11023)
+// Description : CDCL Sat Solver engine in C++11, Ansi-style
+//               Watched literal propagation, first-UIP learning with
+//               clause minimization, VSIDS, restarts, LBD based clause
+//               deletion and phase saving, behind an incremental interface:
+//               variables and clauses can be added between calls to
+//               solve(), which takes assumptions and keeps what it learnt.
+//============================================================================
+
+#ifndef CDCL_H_
+#define CDCL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dimacs.h"
+#include "drat.h"
+
+//  Instead of decaying every activity after each conflict, the bump
+//  grows by 1 / decay_factor and everything is rescaled once it gets big.
+static const double decay_factor = 0.95;
+static const double activity_limit = 1e100;
+
+//  With rephasing on, every rephase_interval * (rephase_count + 1)
+//  conflicts the saved phases are reset to the next entry of
+//  rephase_schedule.
+enum rephase_t {
+    rephase_original, rephase_inverted, rephase_best, rephase_random
+};
+static const rephase_t rephase_schedule[] = { rephase_original, rephase_best,
+        rephase_inverted, rephase_best, rephase_random, rephase_best };
+static const unsigned rephase_interval = 1000;
+
+static const unsigned random_restart_threshold = 500;
+
+//  Learnt clauses with an LBD of at most core_lbd are kept forever, those
+//  up to tier2_lbd survive while they keep taking part in conflicts, and
+//  half of the rest is deleted every reduce_interval conflicts, an
+//  interval which grows by reduce_increment each time.
+static const unsigned core_lbd = 2;
+static const unsigned tier2_lbd = 6;
+static const unsigned first_reduce_interval = 2000;
+static const unsigned reduce_increment = 300;
+
+//  Decides when cdcl() restarts.  It is told about every conflict, with
+//  the LBD of the clause learnt and the trail size before backjumping.
+class restart_policy_t {
+ public:
+    virtual ~restart_policy_t() {
+    }
+
+    virtual void on_conflict(unsigned lbd, unsigned trail_size) = 0;
+
+    virtual bool should_restart() = 0;
+
+    virtual void on_restart() = 0;
+};
+
+//  Restart after every fixed no. of conflicts.
+class fixed_restart_policy_t : public restart_policy_t {
+    unsigned conflicts = 0;
+    unsigned threshold;
+
+ public:
+    explicit fixed_restart_policy_t(unsigned threshold)
+            : threshold { threshold } {
+    }
+
+    void on_conflict(unsigned, unsigned) override {
+        conflicts++;
+    }
+
+    bool should_restart() override {
+        return conflicts > threshold;
+    }
+
+    void on_restart() override {
+        conflicts = 0;
+    }
+};
+
+//  Restart after unit times the terms of the Luby sequence
+//  1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ... conflicts.
+class luby_restart_policy_t : public restart_policy_t {
+    unsigned conflicts = 0;
+    unsigned restarts = 0;
+    unsigned unit;
+
+    static unsigned luby(unsigned index) {
+        unsigned size = 1, power = 0;
+        while (size < index + 1) {
+            size = (size << 1) + 1;
+            power++;
+        }
+        while (size - 1 != index) {
+            size >>= 1;
+            power--;
+            index %= size;
+        }
+        return 1u << power;
+    }
+
+ public:
+    explicit luby_restart_policy_t(unsigned unit)
+            : unit { unit } {
+    }
+
+    void on_conflict(unsigned, unsigned) override {
+        conflicts++;
+    }
+
+    bool should_restart() override {
+        return conflicts >= unit * luby(restarts);
+    }
+
+    void on_restart() override {
+        conflicts = 0;
+        restarts++;
+    }
+};
+
+//  Exponential moving average; the first 1 / alpha values are averaged
+//  uniformly so that it does not start out biased towards zero.
+class moving_average_t {
+    double value = 0;
+    double alpha;
+    unsigned long count = 0;
+
+ public:
+    explicit moving_average_t(double alpha)
+            : alpha { alpha } {
+    }
+
+    void update(double x) {
+        count++;
+        value += std::max(alpha, 1.0 / count) * (x - value);
+    }
+
+    double get() const {
+        return value;
+    }
+};
+
+//  Glucose style: restart once the recent learnt clauses are markedly
+//  worse than average, i.e. the fast LBD average exceeds the slow one by
+//  margin.  With blocking, a conflict reached with a trail much longer
+//  than usual suggests the solver is close to a model and postpones the
+//  next restart.
+class glucose_restart_policy_t : public restart_policy_t {
+    moving_average_t fast_lbd { 1.0 / 32 };
+    moving_average_t slow_lbd { 1.0 / 16384 };
+    moving_average_t trail { 1.0 / 4096 };
+    unsigned long conflicts = 0;
+    unsigned conflicts_since_restart = 0;
+    bool blocking;
+
+    static constexpr double margin = 1.25;
+    static constexpr double block_margin = 1.4;
+    static const unsigned min_conflicts = 50;
+    static const unsigned long block_after = 10000;
+
+ public:
+    explicit glucose_restart_policy_t(bool blocking)
+            : blocking { blocking } {
+    }
+
+    void on_conflict(unsigned lbd, unsigned trail_size) override {
+        conflicts++;
+        conflicts_since_restart++;
+        if (blocking && conflicts > block_after
+                && conflicts_since_restart >= min_conflicts
+                && trail_size > block_margin * trail.get())
+            conflicts_since_restart = 0;
+        trail.update(trail_size);
+        fast_lbd.update(lbd);
+        slow_lbd.update(lbd);
+    }
+
+    bool should_restart() override {
+        return conflicts_since_restart >= min_conflicts
+                && fast_lbd.get() > margin * slow_lbd.get();
+    }
+
+    void on_restart() override {
+        conflicts_since_restart = 0;
+    }
+};
+
+typedef uint32_t clause_ref_t;
+
+//  Clause header, followed inline by its literals in the clause arena.
+//  The two watched literals are always kept at positions 0 and 1.
+class cdcl_clause_t {
+    uint32_t my_size;
+    uint32_t is_learnt : 1;
+    uint32_t is_deleted : 1;
+    uint32_t is_used : 1;
+    uint32_t is_relocated : 1;
+    uint32_t my_lbd : 28;
+
+ public:
+    cdcl_clause_t(const int* literals_begin, const int* literals_end, bool learnt)
+            : my_size { static_cast<uint32_t>(literals_end - literals_begin) },
+              is_learnt { learnt },
+              is_deleted { 0 },
+              is_used { 0 },
+              is_relocated { 0 },
+              my_lbd { 0 } {
+        std::copy(literals_begin, literals_end, begin());
+    }
+
+    //  No. of 32-bit words taken by a clause with the given no. of literals.
+    static unsigned words(unsigned no_of_literals) {
+        return (sizeof(cdcl_clause_t) >> 2) + no_of_literals;
+    }
+
+    unsigned size() const {
+        return my_size;
+    }
+
+    int& operator[](const unsigned index) {
+        return begin()[index];
+    }
+
+    bool learnt() const {
+        return is_learnt;
+    }
+
+    bool deleted() const {
+        return is_deleted;
+    }
+
+    void mark_deleted() {
+        is_deleted = 1;
+    }
+
+    bool used() const {
+        return is_used;
+    }
+
+    void set_used(bool used) {
+        is_used = used;
+    }
+
+    unsigned lbd() const {
+        return my_lbd;
+    }
+
+    void set_lbd(unsigned lbd) {
+        my_lbd = std::min(lbd, (1u << 28) - 1);
+    }
+
+    //  Once moved to a new arena, the first literal holds the new offset.
+    bool relocated() const {
+        return is_relocated;
+    }
+
+    clause_ref_t relocation() {
+        return static_cast<clause_ref_t>(begin()[0]);
+    }
+
+    void relocate(clause_ref_t ref) {
+        is_relocated = 1;
+        begin()[0] = static_cast<int>(ref);
+    }
+
+    int* begin() {
+        return reinterpret_cast<int*>(this + 1);
+    }
+
+    int* end() {
+        return begin() + my_size;
+    }
+
+};
+
+//  All clauses live in one contiguous block of 32-bit words and are
+//  addressed by their word offset, so a clause_ref_t stays valid when
+//  the arena grows while a cdcl_clause_t& does not.
+class clause_arena_t {
+    std::vector<uint32_t> memory;
+    size_t wasted_words = 0;
+
+ public:
+    //  Size limit of the arena in words, set by the 31 bits watcher_t keeps
+    //  of a clause_ref_t; alloc() throws std::length_error beyond it rather
+    //  than hand out refs that would be truncated.
+    static const size_t max_words = size_t(1) << 31;
+
+    clause_ref_t alloc(const int* literals_begin, const int* literals_end,
+                       bool learnt = false) {
+        clause_ref_t ref = static_cast<clause_ref_t>(memory.size());
+        size_t words = cdcl_clause_t::words(literals_end - literals_begin);
+        if (memory.size() + words > max_words)
+            throw std::length_error("clause arena is over 2^31 words");
+        memory.resize(memory.size() + words);
+        new (&memory[ref]) cdcl_clause_t(literals_begin, literals_end, learnt);
+        return ref;
+    }
+
+    clause_ref_t alloc(const std::vector<int>& literals, bool learnt = false) {
+        return alloc(literals.data(), literals.data() + literals.size(),
+                     learnt);
+    }
+
+    void free(const clause_ref_t ref) {
+        (*this)[ref].mark_deleted();
+        wasted_words += cdcl_clause_t::words((*this)[ref].size());
+    }
+
+    //  Copy the clause at ref into the arena to, unless already done,
+    //  and update ref to its offset there.
+    void relocate(clause_ref_t& ref, clause_arena_t& to) {
+        cdcl_clause_t& clause = (*this)[ref];
+        if (!clause.relocated()) {
+            clause_ref_t new_ref = static_cast<clause_ref_t>(to.memory.size());
+            unsigned words = cdcl_clause_t::words(clause.size());
+            to.memory.insert(to.memory.end(), &memory[ref],
+                             &memory[ref] + words);
+            clause.relocate(new_ref);
+        }
+        ref = clause.relocation();
+    }
+
+    size_t size() const {
+        return memory.size();
+    }
+
+    size_t wasted() const {
+        return wasted_words;
+    }
+
+    void swap(clause_arena_t& other) {
+        memory.swap(other.memory);
+        std::swap(wasted_words, other.wasted_words);
+    }
+
+    cdcl_clause_t& operator[](const clause_ref_t ref) {
+        return *reinterpret_cast<cdcl_clause_t*>(&memory[ref]);
+    }
+
+    void reserve(size_t no_of_words) {
+        memory.reserve(no_of_words);
+    }
+};
+
+static const clause_ref_t null_clause =
+        std::numeric_limits<clause_ref_t>::max();
+
+//  Indexed binary max-heap of variables keyed on variable_activity.
+//  Assigned variables are removed lazily by pick_literal() and put
+//  back by backtrack().
+class variable_heap_t {
+    std::vector<unsigned> heap;
+    std::vector<int> position;
+    const double* activity = nullptr;
+
+    bool higher(unsigned i, unsigned j) const {
+        return activity[i] > activity[j];
+    }
+
+    void percolate_up(unsigned i) {
+        unsigned variable = heap[i];
+        while (i > 0 && higher(variable, heap[(i - 1) >> 1])) {
+            heap[i] = heap[(i - 1) >> 1];
+            position[heap[i]] = i;
+            i = (i - 1) >> 1;
+        }
+        heap[i] = variable;
+        position[variable] = i;
+    }
+
+    void percolate_down(unsigned i) {
+        unsigned variable = heap[i];
+        while ((i << 1) + 1 < heap.size()) {
+            unsigned child = (i << 1) + 1;
+            if (child + 1 < heap.size() && higher(heap[child + 1], heap[child]))
+                child++;
+            if (!higher(heap[child], variable))
+                break;
+            heap[i] = heap[child];
+            position[heap[i]] = i;
+            i = child;
+        }
+        heap[i] = variable;
+        position[variable] = i;
+    }
+
+ public:
+    //  Make room for variables up to no_of_variables, keyed on the given
+    //  activities, which may have moved.
+    void resize(unsigned no_of_variables, const double* variable_activity) {
+        activity = variable_activity;
+        position.resize(no_of_variables + 1, -1);
+        heap.reserve(no_of_variables);
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    bool contains(unsigned variable) const {
+        return position[variable] >= 0;
+    }
+
+    void insert(unsigned variable) {
+        position[variable] = static_cast<int>(heap.size());
+        heap.push_back(variable);
+        percolate_up(position[variable]);
+    }
+
+    //  Restore the heap order after the activity of variable increased.
+    void increase(unsigned variable) {
+        if (contains(variable))
+            percolate_up(position[variable]);
+    }
+
+    unsigned remove_max() {
+        unsigned variable = heap.front();
+        heap.front() = heap.back();
+        position[heap.front()] = 0;
+        position[variable] = -1;
+        heap.pop_back();
+        if (!heap.empty())
+            percolate_down(0);
+        return variable;
+    }
+};
+
+//  Entry of a literal's watch list.  The blocker is some other literal of
+//  the clause; while it is true the clause is satisfied and is not visited.
+//  In a binary clause the blocker is the only other literal, so the clause
+//  is never visited at all.  Taking a bit for that limits the clause arena
+//  to clause_arena_t::max_words.
+struct watcher_t {
+    clause_ref_t clause : 31;
+    clause_ref_t binary : 1;
+    int blocker;
+
+    watcher_t(clause_ref_t clause, int blocker, bool binary = false)
+            : clause { clause },
+              binary { binary },
+              blocker { blocker } {
+    }
+};
+
+//  Entry of a literal's list of input clauses of three literals, holding
+//  the two others.  Such a clause is listed under each of its literals, so
+//  no watch ever moves and propagating it never visits the clause.  Learnt
+//  ones, which would be visited far more often that way, are watched as
+//  usual.
+struct ternary_watcher_t {
+    int first;
+    int second;
+    clause_ref_t clause;
+};
+
+inline unsigned watch_index(int literal) {
+    return (static_cast<unsigned>(abs(literal)) << 1) | (literal < 0);
+}
+
+//  Clauses published by one portfolio worker for the others.  Only the
+//  owner writes, into the oldest slot, so readers that fall more than
+//  capacity clauses behind lose the overwritten ones.  Each slot is a
+//  seqlock: its sequence is odd while being written and 2 * (position + 1)
+//  once the clause at that position is complete, so a reader can tell a
+//  torn or stale copy and drop it without ever blocking the writer.
+class clause_ring_t {
+ public:
+    static const unsigned capacity = 1024;
+    static const unsigned max_size = 8;
+
+ private:
+    struct slot_t {
+        std::atomic<uint64_t> sequence { 0 };
+        std::atomic<unsigned> size { 0 };
+        std::atomic<int> literals[max_size];
+    };
+
+    slot_t slots[capacity];
+    std::atomic<uint64_t> head { 0 };
+
+ public:
+    //  Publish a clause of at most max_size literals.
+    void push(const int* begin, const int* end) {
+        uint64_t position = head.load(std::memory_order_relaxed);
+        slot_t& slot = slots[position % capacity];
+        slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.size.store(static_cast<unsigned>(end - begin),
+                        std::memory_order_relaxed);
+        for (unsigned i = 0; begin + i != end; i++)
+            slot.literals[i].store(begin[i], std::memory_order_relaxed);
+        slot.sequence.store(2 * position + 2, std::memory_order_release);
+        head.store(position + 1, std::memory_order_release);
+    }
+
+    uint64_t written() const {
+        return head.load(std::memory_order_acquire);
+    }
+
+    //  Copy the clause at position into clause; false if it has been
+    //  overwritten in the meantime.
+    bool read(uint64_t position, std::vector<int>& clause) const {
+        const slot_t& slot = slots[position % capacity];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * position + 2)
+            return false;
+        unsigned size = slot.size.load(std::memory_order_relaxed);
+        if (size > max_size)
+            size = max_size;
+        clause.resize(size);
+        for (unsigned i = 0; i < size; i++)
+            clause[i] = slot.literals[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == sequence;
+    }
+};
+
+//  What the workers of a portfolio share: one ring of clauses per worker,
+//  each reader's position in every other ring, and the flag that stops
+//  them all once one has an answer.
+class clause_exchange_t {
+    std::vector<std::unique_ptr<clause_ring_t>> rings;
+    std::vector<std::vector<uint64_t>> read_positions;
+
+ public:
+    std::atomic<bool> stop { false };
+
+    explicit clause_exchange_t(unsigned no_of_workers)
+            : read_positions(no_of_workers,
+                             std::vector<uint64_t>(no_of_workers)) {
+        for (unsigned i = 0; i < no_of_workers; i++)
+            rings.emplace_back(new clause_ring_t);
+    }
+
+    void export_clause(unsigned worker, const int* begin, const int* end) {
+        rings[worker]->push(begin, end);
+    }
+
+    //Input :   A worker and a function taking a std::vector<int>&.
+    //
+    //Output:   Call it with every clause the other workers exported since
+    //          this worker last imported, as far as it was not overwritten.
+    template<typename function_t>
+    void import_clauses(unsigned worker, function_t function) {
+        std::vector<int> clause;
+        for (unsigned i = 0; i < rings.size(); i++) {
+            if (i == worker)
+                continue;
+            uint64_t& position = read_positions[worker][i];
+            uint64_t end = rings[i]->written();
+            if (end - position > clause_ring_t::capacity)
+                position = end - clause_ring_t::capacity;
+            for (; position < end; position++)
+                if (rings[i]->read(position, clause))
+                    function(clause);
+        }
+    }
+};
+
+//  Tuning of one solver; the portfolio gives each worker different ones.
+struct cdcl_options_t {
+    std::string restart = "glucose";
+    bool restart_blocking = true;
+    bool rephasing = false;
+    bool inverted_phase = false;    //  Flip the default polarity.
+    unsigned seed = 0;              //  Nonzero: randomize initial activities.
+    double progress_interval = 0;   //  Seconds between progress lines, 0: none.
+};
+
+//Output:   The restart policy named by the options, nullptr if unknown.
+inline restart_policy_t* make_restart_policy(const cdcl_options_t& options) {
+    if (options.restart == "fixed")
+        return new fixed_restart_policy_t(random_restart_threshold);
+    if (options.restart == "luby")
+        return new luby_restart_policy_t(100);
+    if (options.restart == "glucose")
+        return new glucose_restart_policy_t(options.restart_blocking);
+    return nullptr;
+}
+
+enum result_t {
+    result_unknown, result_sat, result_unsat
+};
+
+//Input :   A point in time.
+//
+//Output:   Returns the seconds elapsed since then.
+inline double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+//  What one solver did so far.  Each solver counts into its own copy with
+//  plain increments, so nothing is shared on the hot path; a portfolio adds
+//  up those of its workers once they are done.
+struct cdcl_statistics_t {
+    unsigned long decisions = 0;
+    unsigned long propagations = 0;     //  Literals whose watches were visited.
+    unsigned long conflicts = 0;
+    unsigned long restarts = 0;
+    unsigned long learnt_clauses = 0;
+    unsigned long learnt_literals = 0;
+    unsigned long lbd_sum = 0;
+    unsigned long deleted_clauses = 0;
+    unsigned long reductions = 0;
+    unsigned long imported_clauses = 0;
+    double propagate_seconds = 0;
+    double analyze_seconds = 0;
+    double reduce_seconds = 0;
+
+    cdcl_statistics_t& operator+=(const cdcl_statistics_t& other) {
+        decisions += other.decisions;
+        propagations += other.propagations;
+        conflicts += other.conflicts;
+        restarts += other.restarts;
+        learnt_clauses += other.learnt_clauses;
+        learnt_literals += other.learnt_literals;
+        lbd_sum += other.lbd_sum;
+        deleted_clauses += other.deleted_clauses;
+        reductions += other.reductions;
+        imported_clauses += other.imported_clauses;
+        propagate_seconds += other.propagate_seconds;
+        analyze_seconds += other.analyze_seconds;
+        reduce_seconds += other.reduce_seconds;
+        return *this;
+    }
+
+    double average_lbd() const {
+        return learnt_clauses ? (double) lbd_sum / learnt_clauses : 0;
+    }
+
+    //Input :   A stream.
+    //
+    //Output:   Write the counters to it as one JSON object.
+    void write_json(std::ostream& out) const {
+        out << "{\"decisions\": " << decisions
+            << ", \"propagations\": " << propagations
+            << ", \"conflicts\": " << conflicts
+            << ", \"restarts\": " << restarts
+            << ", \"learnt_clauses\": " << learnt_clauses
+            << ", \"learnt_literals\": " << learnt_literals
+            << ", \"average_lbd\": " << average_lbd()
+            << ", \"deleted_clauses\": " << deleted_clauses
+            << ", \"reductions\": " << reductions
+            << ", \"imported_clauses\": " << imported_clauses
+            << ", \"propagate_seconds\": " << propagate_seconds
+            << ", \"analyze_seconds\": " << analyze_seconds
+            << ", \"reduce_seconds\": " << reduce_seconds << '}';
+    }
+};
+
+//  All the state of one CDCL search, so that several can run side by side.
+class cdcl_solver_t {
+    int* variable_assignments = nullptr;
+    int* variable_decision_level = nullptr;
+    //  Indexed by watch_index(literal).
+    double* variable_priority = nullptr;
+    double* variable_activity = nullptr;
+    double activity_increment = 1.0;
+
+    //  Polarity of each variable when it was last unassigned (1 or -1, 0 if
+    //  never assigned), and the one it had on the longest trail seen since
+    //  the last rephase.
+    int* variable_saved_phase = nullptr;
+    int* variable_best_phase = nullptr;
+    unsigned best_trail_size = 0;
+
+    bool rephasing;
+    bool inverted_phase;
+    unsigned rephase_count = 0;
+    unsigned long next_rephase_conflicts = rephase_interval;
+    std::default_random_engine rand_eng;
+    bool jitter_activity;
+
+    //  The per-variable arrays have room for variable_capacity variables.
+    unsigned no_of_variables = 0;
+    unsigned variable_capacity = 0;
+
+    unsigned long no_of_conflicts = 0;
+    unsigned long next_reduce_conflicts = first_reduce_interval;
+    unsigned reduce_interval = first_reduce_interval;
+
+    std::unique_ptr<restart_policy_t> restart_policy;
+
+    clause_arena_t clause_arena;
+    std::vector<clause_ref_t> sat_instance;
+    std::vector<clause_ref_t> learnt_clauses;
+    std::vector<clause_ref_t> variable_antecedent;
+
+    //  Literals in the order they were assigned; those before
+    //  propagation_head have already had their watches visited, and
+    //  trail_limits[d] is where the literals of decision level d + 1 begin.
+    std::vector<int> trail;
+    std::vector<unsigned> trail_limits;
+    unsigned propagation_head = 0;
+
+    variable_heap_t variable_heap;
+
+    //  watches[watch_index(l)] holds the clauses watching literal l, which
+    //  are visited when l becomes false; those of three literals are on a
+    //  list of their own, next to the other so that both share a cache line.
+    struct watch_lists_t {
+        std::vector<watcher_t> watchers;
+        std::vector<ternary_watcher_t> ternary;
+    };
+    std::vector<watch_lists_t> watches;
+
+    unsigned no_of_variables_assigned = 0;
+    unsigned no_of_variables_eliminated = 0;
+    //  Set once a conflict at decision level 0 shows that the formula
+    //  itself has no model, whatever is assumed.
+    bool unsatisfiable = false;
+
+    //  What the last solve() found: the model, if SAT, and otherwise the
+    //  assumptions that cannot hold together.
+    std::vector<int> model_assignments;
+    std::vector<int> conflict_assumptions;
+    std::vector<int> clause_buffer;
+    std::vector<char> variable_eliminated;
+
+    //  Per-variable marks used by conflict_analysis, and the literals whose
+    //  marks have to be cleared once it is done.
+    std::vector<char> seen;
+    std::vector<int> analyze_to_clear;
+
+    //  Per-level stamps used to count the distinct levels of a clause.
+    std::vector<unsigned> level_stamp;
+    unsigned level_stamp_counter = 0;
+
+    //  Set when running in a portfolio: learnt clauses of at most
+    //  clause_ring_t::max_size literals and an LBD of at most share_lbd are
+    //  exported, and those of the other workers imported at every restart.
+    clause_exchange_t* exchange = nullptr;
+    unsigned worker = 0;
+    static const unsigned share_lbd = 2;
+
+    //  With a progress_interval, every progress_check conflicts the clock is
+    //  read and, once the interval has passed, a progress line printed.
+    cdcl_statistics_t stats;
+    double progress_interval;
+    std::chrono::steady_clock::time_point start_time;
+    double next_progress = 0;
+    static const unsigned progress_check = 1024;
+
+    //  If set, every clause learnt or deleted is logged to it, and so is the
+    //  empty clause once the formula is found unsatisfiable.
+    drat_writer_t* proof = nullptr;
+
+    void attach_clause(clause_ref_t ref) {
+        cdcl_clause_t& clause = clause_arena[ref];
+        if (clause.size() < 2)
+            return;
+        if (clause.size() == 3 && !clause.learnt()) {
+            watches[watch_index(clause[0])].ternary.push_back(
+                    { clause[1], clause[2], ref });
+            watches[watch_index(clause[1])].ternary.push_back(
+                    { clause[0], clause[2], ref });
+            watches[watch_index(clause[2])].ternary.push_back(
+                    { clause[0], clause[1], ref });
+            return;
+        }
+        bool binary = clause.size() == 2;
+        watches[watch_index(clause[0])].watchers.push_back(
+                { ref, clause[1], binary });
+        watches[watch_index(clause[1])].watchers.push_back(
+                { ref, clause[0], binary });
+    }
+
+    inline uint32_t abstract_level(unsigned variable) {
+        return 1u << (variable_decision_level[variable] & 31);
+    }
+
+    static bool absolute_comparator(int i, int j) {
+        return abs(i) < abs(j);
+    }
+
+    template<typename value_t>
+    static void grow_array(value_t*& array, size_t old_size, size_t new_size) {
+        array = static_cast<value_t*>(realloc(array, new_size * sizeof(value_t)));
+        std::fill(array + old_size, array + new_size, value_t());
+    }
+
+    //Input :   The new no. of variables, at least the current one.
+    //
+    //Output:   Grow every per-variable array, doubling the capacity so that
+    //          adding variables one at a time stays linear, and make the new
+    //          variables unassigned and ready to be decided.
+    void resize_variables(unsigned new_no_of_variables) {
+        if (new_no_of_variables <= no_of_variables)
+            return;
+        if (new_no_of_variables > variable_capacity) {
+            unsigned capacity = std::max(new_no_of_variables,
+                                         variable_capacity << 1);
+            size_t old_size = variable_capacity ? variable_capacity + 1 : 0;
+            size_t old_literals = variable_capacity ?
+                    (variable_capacity << 1) + 2 : 0;
+            grow_array(variable_assignments, old_size, capacity + 1);
+            grow_array(variable_decision_level, old_size, capacity + 1);
+            grow_array(variable_priority, old_literals, (capacity << 1) + 2);
+            grow_array(variable_activity, old_size, capacity + 1);
+            grow_array(variable_saved_phase, old_size, capacity + 1);
+            grow_array(variable_best_phase, old_size, capacity + 1);
+            variable_capacity = capacity;
+            variable_heap.resize(capacity, variable_activity);
+        }
+        watches.resize((new_no_of_variables << 1) + 2);
+        variable_antecedent.resize(new_no_of_variables + 1, null_clause);
+        variable_eliminated.resize(new_no_of_variables + 1, 0);
+        seen.resize(new_no_of_variables + 1, 0);
+        if (level_stamp.size() <= new_no_of_variables)
+            level_stamp.resize(new_no_of_variables + 1, 0);
+
+        //  A tiny random activity only breaks the initial ties differently.
+        std::uniform_real_distribution<double> jitter(0, 1e-3);
+        for (unsigned i = no_of_variables + 1; i <= new_no_of_variables; i++) {
+            variable_decision_level[i] = -1;
+            if (jitter_activity)
+                variable_activity[i] = jitter(rand_eng);
+            variable_heap.insert(i);
+        }
+        no_of_variables = new_no_of_variables;
+    }
+
+    //Input :   A literal to be made true at the given decision level and the
+    //          clause that implied it, null_clause for decisions.
+    //
+    //Output:   Record the assignment and queue it on the trail for propagation.
+    void assign_literal(int literal, int decision_level, clause_ref_t antecedent) {
+        variable_assignments[abs(literal)] = literal;
+        variable_decision_level[abs(literal)] = decision_level;
+        if (decision_level > 0)
+            variable_antecedent[abs(literal)] = antecedent;
+        no_of_variables_assigned++;
+        trail.push_back(literal);
+    }
+
+    //Input :   Current decision level, and a reference to return a conflict in.
+    //
+    //Output:   Propagate every literal queued on the trail since the last call.
+    //          Only clauses watching the negation of such a literal are
+    //          visited: a clause is skipped if its blocker is true, otherwise
+    //          its watch moves to a non-false literal; if none exists the other
+    //          watch is implied, or, when that is false too, the clause is
+    //          returned as unsat_clause and false is returned.  A binary
+    //          clause goes straight from its blocker to the implication or
+    //          conflict, and a ternary one from the two literals its
+    //          ternary watcher holds.
+    bool propagate(int decision_level, clause_ref_t& unsat_clause) {
+        while (propagation_head < trail.size()) {
+            const int false_literal = -trail[propagation_head++];
+            stats.propagations++;
+            for (const ternary_watcher_t& watcher :
+                    watches[watch_index(false_literal)].ternary) {
+                const int value_1 = variable_assignments[abs(watcher.first)];
+                const int value_2 = variable_assignments[abs(watcher.second)];
+                if (value_1 == watcher.first || value_2 == watcher.second)
+                    continue;
+                if (value_1 == 0) {
+                    if (value_2 != 0)
+                        assign_literal(watcher.first, decision_level,
+                                       watcher.clause);
+                } else if (value_2 == 0) {
+                    assign_literal(watcher.second, decision_level,
+                                   watcher.clause);
+                } else {
+                    unsat_clause = watcher.clause;
+                    propagation_head = static_cast<unsigned>(trail.size());
+                    return false;
+                }
+            }
+
+            std::vector<watcher_t>& watch_list =
+                    watches[watch_index(false_literal)].watchers;
+            auto i = watch_list.begin(), j = i, end = watch_list.end();
+            while (i != end) {
+                const int blocker = i->blocker;
+                const int value = variable_assignments[abs(blocker)];
+                if (value == blocker) {
+                    *j++ = *i++;
+                    continue;
+                }
+                if (i->binary) {
+                    clause_ref_t ref = i->clause;
+                    *j++ = *i++;
+                    if (value == 0) {
+                        assign_literal(blocker, decision_level, ref);
+                        continue;
+                    }
+                    unsat_clause = ref;
+                    propagation_head = static_cast<unsigned>(trail.size());
+                    while (i != end)
+                        *j++ = *i++;
+                    watch_list.erase(j, end);
+                    return false;
+                }
+                clause_ref_t ref = i->clause;
+                cdcl_clause_t& clause = clause_arena[ref];
+                if (clause[0] == false_literal)
+                    std::swap(clause[0], clause[1]);
+                i++;
+
+                int first = clause[0];
+                watcher_t watcher { ref, first };
+                if (variable_assignments[abs(first)] == first) {
+                    *j++ = watcher;
+                    continue;
+                }
+
+                bool moved = false;
+                for (unsigned k = 2; k < clause.size(); k++) {
+                    if (variable_assignments[abs(clause[k])] != -clause[k]) {
+                        clause[1] = clause[k];
+                        clause[k] = false_literal;
+                        watches[watch_index(clause[1])].watchers.push_back(
+                                watcher);
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved)
+                    continue;
+
+                *j++ = watcher;
+                if (variable_assignments[abs(first)] == -first) {
+                    unsat_clause = ref;
+                    propagation_head = static_cast<unsigned>(trail.size());
+                    while (i != end)
+                        *j++ = *i++;
+                    watch_list.erase(j, end);
+                    return false;
+                }
+                assign_literal(first, decision_level, ref);
+            }
+            watch_list.erase(j, end);
+        }
+        return true;
+    }
+
+    //  propagate(), timed.
+    bool unit_propagate(int decision_level, clause_ref_t& unsat_clause) {
+        auto start = std::chrono::steady_clock::now();
+        bool consistent = propagate(decision_level, unsat_clause);
+        stats.propagate_seconds += seconds_since(start);
+        return consistent;
+    }
+
+    //Output:   Print a progress line to stderr if progress_interval seconds
+    //          have passed since the last one.
+    void report_progress() {
+        double elapsed = seconds_since(start_time);
+        if (elapsed < next_progress)
+            return;
+        next_progress = elapsed + progress_interval;
+        std::ostringstream line;
+        line << "c [" << worker << "] " << elapsed << "s conflicts "
+             << no_of_conflicts << " decisions " << stats.decisions
+             << " propagations " << stats.propagations << " restarts "
+             << stats.restarts << " learnt " << learnt_clauses.size()
+             << " avg-lbd " << stats.average_lbd() << '\n';
+        std::cerr << line.str();
+    }
+
+    bool all_variables_assigned() {
+        return no_of_variables_assigned + no_of_variables_eliminated
+                == no_of_variables;
+    }
+
+    //Input :   A variable.
+    //
+    //Output:   Returns 1 or -1, the polarity of higher variable_priority.
+    inline int priority_phase(int variable) {
+        return variable_priority[watch_index(-variable)]
+                > variable_priority[watch_index(variable)] ? -1 : 1;
+    }
+
+    //Output:   Pop the unassigned variable of highest activity off the heap
+    //          and return it with its saved phase, if it has one, or else the
+    //          polarity of higher variable_priority.
+    int pick_literal() {
+        while (!variable_heap.empty()) {
+            int variable = static_cast<int>(variable_heap.remove_max());
+            if (variable_assignments[variable] != 0
+                    || variable_eliminated[variable])
+                continue;
+            if (variable_saved_phase[variable] != 0)
+                return variable_saved_phase[variable] * variable;
+            return (inverted_phase ? -1 : 1) * priority_phase(variable)
+                    * variable;
+        }
+        return 0;
+    }
+
+    //Output:   Overwrite the saved phases according to the next entry of the
+    //          rephase schedule and schedule the following rephase.
+    void rephase() {
+        const unsigned schedule_length = sizeof(rephase_schedule)
+                / sizeof(rephase_schedule[0]);
+        for (int i = 1; i <= (int) no_of_variables; i++) {
+            switch (rephase_schedule[rephase_count % schedule_length]) {
+            case rephase_original:
+                variable_saved_phase[i] = 0;
+                break;
+            case rephase_inverted:
+                variable_saved_phase[i] = -priority_phase(i);
+                break;
+            case rephase_best:
+                if (variable_best_phase[i] != 0)
+                    variable_saved_phase[i] = variable_best_phase[i];
+                break;
+            case rephase_random:
+                variable_saved_phase[i] = rand_eng() % 2 ? 1 : -1;
+                break;
+            }
+        }
+        best_trail_size = 0;
+        rephase_count++;
+        next_rephase_conflicts = no_of_conflicts
+                + static_cast<unsigned long>(rephase_interval) * (rephase_count + 1);
+    }
+
+    //Input :   A literal of a learnt clause.
+    //
+    //Output:   Bump the activity of its variable and the priority of the
+    //          literal itself, rescaling all of them if they grow too large.
+    void bump_literal(int literal) {
+        unsigned variable = abs(literal);
+        variable_priority[watch_index(literal)] += activity_increment;
+        variable_activity[variable] += activity_increment;
+        if (variable_activity[variable] > activity_limit) {
+            for (unsigned i = 2; i <= (no_of_variables << 1) + 1; i++)
+                variable_priority[i] /= activity_limit;
+            for (unsigned i = 1; i <= no_of_variables; i++)
+                variable_activity[i] /= activity_limit;
+            activity_increment /= activity_limit;
+        }
+        variable_heap.increase(variable);
+    }
+
+    //Input :   The literals of a clause, all of them assigned.
+    //
+    //Output:   Returns its literal block distance, the no. of distinct
+    //          decision levels among its literals.
+    unsigned compute_lbd(const int* begin, const int* end) {
+        level_stamp_counter++;
+        unsigned lbd = 0;
+        for (const int* a = begin; a != end; a++) {
+            int level = variable_decision_level[abs(*a)];
+            if (level_stamp[level] != level_stamp_counter) {
+                level_stamp[level] = level_stamp_counter;
+                lbd++;
+            }
+        }
+        return lbd;
+    }
+
+    //Input :   A literal of the learnt clause and the set of decision levels
+    //          present in it, as a bitmask of (level mod 32).
+    //
+    //Output:   Returns true if the literal is implied by the other literals of
+    //          the learnt clause, i.e. every path back from its antecedent ends
+    //          in a literal already marked seen.  Literals visited on the way
+    //          are marked and recorded in analyze_to_clear.
+    bool literal_redundant(int literal, uint32_t abstract_levels) {
+        std::vector<int> stack(1, literal);
+        const size_t top = analyze_to_clear.size();
+        while (!stack.empty()) {
+            unsigned variable = abs(stack.back());
+            stack.pop_back();
+            for (auto a : clause_arena[variable_antecedent[variable]]) {
+                unsigned v = abs(a);
+                if (v == variable || seen[v] || variable_decision_level[v] == 0)
+                    continue;
+                if (variable_antecedent[v] != null_clause
+                        && (abstract_level(v) & abstract_levels)) {
+                    seen[v] = 1;
+                    stack.push_back(a);
+                    analyze_to_clear.push_back(a);
+                } else {
+                    for (size_t i = top; i < analyze_to_clear.size(); i++)
+                        seen[abs(analyze_to_clear[i])] = 0;
+                    analyze_to_clear.resize(top);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //Input :   Current decision level, the clause found unsatisfiable and a
+    //          reference to return the learnt clause in.
+    //
+    //Output:   Derive the first-UIP clause by resolving current-level literals
+    //          in reverse trail order, drop the literals implied by the rest of
+    //          the clause, add it to the formula and return the level to
+    //          backtrack to.  The asserting literal is placed at position 0
+    //          and the literal of the backtrack level at position 1.
+    int conflict_analysis(int decision_level, clause_ref_t unsat_clause,
+                          clause_ref_t& learnt_ref) {
+        auto start = std::chrono::steady_clock::now();
+        no_of_conflicts++;
+        std::vector<int> learnt_clause(1, 0);
+        int path_count = 0;
+        int literal = 0;
+        int index = static_cast<int>(trail.size()) - 1;
+        clause_ref_t reason = unsat_clause;
+        do {
+            cdcl_clause_t& clause = clause_arena[reason];
+            if (clause.learnt() && clause.lbd() > core_lbd) {
+                clause.set_used(true);
+                unsigned lbd = compute_lbd(clause.begin(), clause.end());
+                if (lbd < clause.lbd())
+                    clause.set_lbd(lbd);
+            }
+            for (auto a : clause) {
+                unsigned variable = abs(a);
+                if (variable == static_cast<unsigned>(abs(literal))
+                        || seen[variable]
+                        || variable_decision_level[variable] == 0)
+                    continue;
+                seen[variable] = 1;
+                bump_literal(a);
+                if (variable_decision_level[variable] == decision_level)
+                    path_count++;
+                else
+                    learnt_clause.push_back(a);
+            }
+            while (!seen[abs(trail[index])])
+                index--;
+            literal = trail[index--];
+            reason = variable_antecedent[abs(literal)];
+            seen[abs(literal)] = 0;
+            path_count--;
+        } while (path_count > 0);
+        learnt_clause[0] = -literal;
+
+        analyze_to_clear.assign(learnt_clause.begin(), learnt_clause.end());
+        uint32_t abstract_levels = 0;
+        for (unsigned i = 1; i < learnt_clause.size(); i++)
+            abstract_levels |= abstract_level(abs(learnt_clause[i]));
+        unsigned j = 1;
+        for (unsigned i = 1; i < learnt_clause.size(); i++) {
+            if (variable_antecedent[abs(learnt_clause[i])] == null_clause
+                    || !literal_redundant(learnt_clause[i], abstract_levels))
+                learnt_clause[j++] = learnt_clause[i];
+        }
+        learnt_clause.resize(j);
+        for (auto a : analyze_to_clear)
+            seen[abs(a)] = 0;
+
+        int backtrack_level = 0;
+        for (unsigned i = 1; i < learnt_clause.size(); i++) {
+            if (variable_decision_level[abs(learnt_clause[i])] > backtrack_level) {
+                backtrack_level = variable_decision_level[abs(learnt_clause[i])];
+                std::swap(learnt_clause[1], learnt_clause[i]);
+            }
+        }
+        activity_increment /= decay_factor;
+        learnt_ref = clause_arena.alloc(learnt_clause, true);
+        clause_arena[learnt_ref].set_lbd(
+                compute_lbd(learnt_clause.data(),
+                            learnt_clause.data() + learnt_clause.size()));
+        attach_clause(learnt_ref);
+        learnt_clauses.push_back(learnt_ref);
+        if (proof)
+            proof->add(learnt_clause.data(),
+                       learnt_clause.data() + learnt_clause.size());
+        stats.learnt_clauses++;
+        stats.learnt_literals += learnt_clause.size();
+        stats.lbd_sum += clause_arena[learnt_ref].lbd();
+        stats.analyze_seconds += seconds_since(start);
+        return backtrack_level;
+    }
+
+    //Input :   A clause reference.
+    //
+    //Output:   Returns true if the clause is the antecedent of an assignment
+    //          and so may not be deleted.  That is its first literal, unless
+    //          it has three and so possibly a ternary watcher, which does not
+    //          keep the implied literal first.
+    inline bool locked(clause_ref_t ref) {
+        cdcl_clause_t& clause = clause_arena[ref];
+        unsigned size = clause.size() == 3 ? 3 : 1;
+        for (unsigned i = 0; i < size; i++)
+            if (variable_assignments[abs(clause[i])] == clause[i]
+                    && variable_antecedent[abs(clause[i])] == ref)
+                return true;
+        return false;
+    }
+
+    //Output:   Move all live clauses into a fresh arena, in watch list order,
+    //          and update every reference to them.
+    void collect_garbage() {
+        clause_arena_t to;
+        to.reserve(clause_arena.size() - clause_arena.wasted());
+        for (auto a : trail) {
+            clause_ref_t& reason = variable_antecedent[abs(a)];
+            if (reason != null_clause)
+                clause_arena.relocate(reason, to);
+        }
+        for (unsigned i = 2; i <= (no_of_variables << 1) + 1; i++) {
+            for (auto& watcher : watches[i].watchers) {
+                clause_ref_t ref = watcher.clause;
+                clause_arena.relocate(ref, to);
+                watcher.clause = ref;
+            }
+            for (auto& watcher : watches[i].ternary)
+                clause_arena.relocate(watcher.clause, to);
+        }
+        for (auto& a : sat_instance)
+            clause_arena.relocate(a, to);
+        for (auto& a : learnt_clauses)
+            clause_arena.relocate(a, to);
+        clause_arena.swap(to);
+    }
+
+    //Output:   Delete the less useful half of the learnt clauses outside the
+    //          core tier, i.e. those with the highest LBD, then the longest,
+    //          sparing clauses that are locked or took part in a conflict
+    //          since the last reduction; then compact the clause arena.
+    void reduce_learnt_clauses() {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<clause_ref_t> candidates;
+        for (auto a : learnt_clauses) {
+            cdcl_clause_t& clause = clause_arena[a];
+            if (clause.lbd() <= core_lbd || clause.size() == 2)
+                continue;
+            if (clause.used()) {
+                clause.set_used(false);
+                if (clause.lbd() <= tier2_lbd)
+                    continue;
+            }
+            if (!locked(a))
+                candidates.push_back(a);
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [this](clause_ref_t a, clause_ref_t b) {
+                      cdcl_clause_t& clause_a = clause_arena[a];
+                      cdcl_clause_t& clause_b = clause_arena[b];
+                      if (clause_a.lbd() != clause_b.lbd())
+                          return clause_a.lbd() > clause_b.lbd();
+                      return clause_a.size() > clause_b.size();
+                  });
+        for (size_t i = 0; i < candidates.size() / 2; i++) {
+            if (proof)
+                proof->remove(clause_arena[candidates[i]].begin(),
+                              clause_arena[candidates[i]].end());
+            clause_arena.free(candidates[i]);
+        }
+        stats.deleted_clauses += candidates.size() / 2;
+        stats.reductions++;
+
+        for (unsigned i = 2; i <= (no_of_variables << 1) + 1; i++) {
+            auto& watch_list = watches[i].watchers;
+            watch_list.erase(
+                    std::remove_if(watch_list.begin(), watch_list.end(),
+                                   [this](const watcher_t& watcher) {
+                                       return clause_arena[watcher.clause].deleted();
+                                   }),
+                    watch_list.end());
+            auto& ternary_list = watches[i].ternary;
+            ternary_list.erase(
+                    std::remove_if(ternary_list.begin(), ternary_list.end(),
+                                   [this](const ternary_watcher_t& watcher) {
+                                       return clause_arena[watcher.clause].deleted();
+                                   }),
+                    ternary_list.end());
+        }
+        learnt_clauses.erase(
+                std::remove_if(learnt_clauses.begin(), learnt_clauses.end(),
+                               [this](clause_ref_t a) {
+                                   return clause_arena[a].deleted();
+                               }),
+                learnt_clauses.end());
+        collect_garbage();
+        stats.reduce_seconds += seconds_since(start);
+    }
+
+    //Input :   Decision level to return to.
+    //
+    //Output:   Undo only the assignments made above that level, which form
+    //          a suffix of the trail, saving the phase of each variable.
+    void backtrack(int backtrack_level) {
+        if (static_cast<int>(trail_limits.size()) <= backtrack_level)
+            return;
+        if (trail.size() > best_trail_size) {
+            best_trail_size = static_cast<unsigned>(trail.size());
+            for (auto a : trail)
+                variable_best_phase[abs(a)] = a > 0 ? 1 : -1;
+        }
+        for (unsigned i = trail_limits[backtrack_level]; i < trail.size(); i++) {
+            unsigned variable = abs(trail[i]);
+            variable_saved_phase[variable] = trail[i] > 0 ? 1 : -1;
+            variable_assignments[variable] = 0;
+            variable_decision_level[variable] = -1;
+            variable_antecedent[variable] = null_clause;
+            if (!variable_heap.contains(variable))
+                variable_heap.insert(variable);
+        }
+        no_of_variables_assigned -= static_cast<unsigned>(trail.size())
+                - trail_limits[backtrack_level];
+        trail.resize(trail_limits[backtrack_level]);
+        trail_limits.resize(backtrack_level);
+        propagation_head = static_cast<unsigned>(trail.size());
+    }
+
+    //Input :   An assumption found false.
+    //
+    //Output:   Set the final conflict to it and the assumptions it is false
+    //          by, found by following antecedents back from its negation to
+    //          the decisions, which at this point are all assumptions.
+    void analyze_final(int assumption) {
+        conflict_assumptions.assign(1, assumption);
+        if (variable_decision_level[abs(assumption)] <= 0)
+            return;
+        seen[abs(assumption)] = 1;
+        for (size_t i = trail.size(); i-- > trail_limits[0];) {
+            unsigned variable = abs(trail[i]);
+            if (!seen[variable])
+                continue;
+            seen[variable] = 0;
+            if (variable_antecedent[variable] == null_clause) {
+                conflict_assumptions.push_back(trail[i]);
+                continue;
+            }
+            for (auto a : clause_arena[variable_antecedent[variable]])
+                if (static_cast<unsigned>(abs(a)) != variable
+                        && variable_decision_level[abs(a)] > 0)
+                    seen[abs(a)] = 1;
+        }
+    }
+
+    //Output:   Add the clauses exported by the other workers, at decision
+    //          level 0: literals false there are dropped, clauses true there
+    //          skipped, and units assigned.  Returns false if a clause is
+    //          false at level 0, i.e. the formula is unsatisfiable.
+    bool import_shared_clauses() {
+        bool consistent = true;
+        auto add = [this, &consistent](std::vector<int>& clause) {
+            if (!consistent)
+                return;
+            unsigned j = 0;
+            for (unsigned i = 0; i < clause.size(); i++) {
+                int value = variable_assignments[abs(clause[i])];
+                if (value == clause[i])
+                    return;
+                if (value == 0)
+                    clause[j++] = clause[i];
+            }
+            clause.resize(j);
+            if (clause.empty()) {
+                consistent = false;
+            } else if (clause.size() == 1) {
+                assign_literal(clause[0], 0, null_clause);
+            } else {
+                clause_ref_t ref = clause_arena.alloc(clause, true);
+                clause_arena[ref].set_lbd(share_lbd);
+                attach_clause(ref);
+                learnt_clauses.push_back(ref);
+            }
+            stats.imported_clauses++;
+        };
+        exchange->import_clauses(worker, add);
+        return consistent;
+    }
+
+    //Input :   Literals to assume true, and a no. of conflicts after which
+    //          to give up, 0 for no limit.
+    //
+    //Output:   The search behind solve(), which leaves the trail as it ends.
+    //          Assumption i is decided at level i + 1, ahead of any other
+    //          decision, so everything learnt follows from the formula alone.
+    result_t search(const std::vector<int>& assumptions,
+                    unsigned long conflict_limit) {
+        int decision_level = 0;
+        clause_ref_t unsat_clause = null_clause;
+        unsigned long last_conflict = conflict_limit ?
+                no_of_conflicts + conflict_limit :
+                std::numeric_limits<unsigned long>::max();
+        if (level_stamp.size() <= no_of_variables + assumptions.size())
+            level_stamp.resize(no_of_variables + assumptions.size() + 1);
+        //  A unit learnt just before the last call hit its conflict limit is
+        //  still unpropagated; its consequences belong to level 0, not to
+        //  the first assumption's level.
+        if (!unit_propagate(0, unsat_clause)) {
+            unsatisfiable = true;
+            if (proof)
+                proof->add_empty();
+            return result_unsat;
+        }
+        int flag = 1;
+        while (!all_variables_assigned()) {
+            if (exchange && exchange->stop.load(std::memory_order_relaxed))
+                return result_unknown;
+            if (flag) {
+                int literal = 0;
+                while (!literal
+                        && decision_level < static_cast<int>(assumptions.size())) {
+                    int assumption = assumptions[decision_level];
+                    int value = variable_assignments[abs(assumption)];
+                    if (value == -assumption) {
+                        analyze_final(assumption);
+                        return result_unsat;
+                    }
+                    if (value == 0) {
+                        literal = assumption;
+                    } else {
+                        //  Already implied; an empty level keeps the levels
+                        //  of the later assumptions in step.
+                        trail_limits.push_back(static_cast<unsigned>(trail.size()));
+                        decision_level++;
+                    }
+                }
+                if (!literal)
+                    literal = pick_literal();
+                trail_limits.push_back(static_cast<unsigned>(trail.size()));
+                decision_level++;
+                assign_literal(literal, decision_level, null_clause);
+                stats.decisions++;
+            }
+            flag = 1;
+            if (!unit_propagate(decision_level, unsat_clause)) {
+                flag = 0;
+                if (decision_level == 0) {
+                    unsatisfiable = true;
+                    if (proof)
+                        proof->add_empty();
+                    return result_unsat;
+                }
+                clause_ref_t learnt_ref;
+                int backtrack_level = conflict_analysis(decision_level,
+                                                        unsat_clause, learnt_ref);
+                cdcl_clause_t& learnt = clause_arena[learnt_ref];
+                if (exchange && learnt.size() <= clause_ring_t::max_size
+                        && learnt.lbd() <= share_lbd)
+                    exchange->export_clause(worker, learnt.begin(),
+                                            learnt.end());
+                restart_policy->on_conflict(clause_arena[learnt_ref].lbd(),
+                                            static_cast<unsigned>(trail.size()));
+                if (restart_policy->should_restart()) {
+                    restart_policy->on_restart();
+                    backtrack_level = 0;
+                    stats.restarts++;
+                }
+                backtrack(backtrack_level);
+                decision_level = backtrack_level;
+
+                //  The learnt clause is asserting unless a restart unassigned
+                //  its second watch as well.
+                cdcl_clause_t& learnt_clause = clause_arena[learnt_ref];
+                if (variable_assignments[abs(learnt_clause[0])] == 0
+                        && (learnt_clause.size() == 1
+                                || variable_assignments[abs(learnt_clause[1])]
+                                        == -learnt_clause[1]))
+                    assign_literal(learnt_clause[0], decision_level, learnt_ref);
+                if (exchange && decision_level == 0 && !import_shared_clauses()) {
+                    unsatisfiable = true;
+                    return result_unsat;
+                }
+
+                if (no_of_conflicts >= next_reduce_conflicts) {
+                    reduce_learnt_clauses();
+                    reduce_interval += reduce_increment;
+                    next_reduce_conflicts = no_of_conflicts + reduce_interval;
+                }
+                if (rephasing && no_of_conflicts >= next_rephase_conflicts)
+                    rephase();
+                if (progress_interval > 0
+                        && no_of_conflicts % progress_check == 0)
+                    report_progress();
+                if (no_of_conflicts >= last_conflict)
+                    return result_unknown;
+            }
+        }
+        for (auto a : assumptions) {
+            if (variable_assignments[abs(a)] != a) {
+                analyze_final(a);
+                return result_unsat;
+            }
+        }
+        return result_sat;
+    }
+
+ public:
+    //Input :   The tuning to solve with.
+    //
+    //Output:   An empty solver, for variables and clauses to be added.
+    explicit cdcl_solver_t(const cdcl_options_t& options = cdcl_options_t())
+            : rephasing { options.rephasing },
+              inverted_phase { options.inverted_phase },
+              rand_eng(options.seed),
+              jitter_activity { options.seed != 0 },
+              restart_policy { make_restart_policy(options) },
+              progress_interval { options.progress_interval },
+              start_time { std::chrono::steady_clock::now() },
+              next_progress { options.progress_interval } {
+    }
+
+    //Input :   The clauses to solve and the tuning to solve them with.
+    //
+    //Output:   Set up the solver state for them.
+    cdcl_solver_t(const dimacs_instance_t& formula, const cdcl_options_t& options)
+            : cdcl_solver_t(options) {
+        unsigned no_of_clauses = formula.no_of_clauses;
+        resize_variables(formula.no_of_variables);
+
+        //  Size the watch lists up front; on large instances growing them a
+        //  watcher at a time costs more than reading the input.
+        std::vector<unsigned> watch_counts((no_of_variables << 1) + 2);
+        std::vector<unsigned> ternary_counts((no_of_variables << 1) + 2);
+        for (unsigned i = 0; i < no_of_clauses; i++) {
+            if (formula.size(i) == 3) {
+                for (const int* a = formula.begin(i); a != formula.end(i); a++)
+                    ternary_counts[watch_index(*a)]++;
+            } else if (formula.size(i) >= 2) {
+                watch_counts[watch_index(formula.begin(i)[0])]++;
+                watch_counts[watch_index(formula.begin(i)[1])]++;
+            }
+        }
+        for (size_t i = 0; i < watch_counts.size(); i++) {
+            watches[i].watchers.reserve(watch_counts[i]);
+            watches[i].ternary.reserve(ternary_counts[i]);
+        }
+
+        trail.reserve(no_of_variables);
+        sat_instance.reserve(no_of_clauses);
+        clause_arena.reserve(formula.no_of_literals()
+                + static_cast<size_t>(no_of_clauses) * cdcl_clause_t::words(0));
+        for (unsigned i = 0; i < no_of_clauses; i++)
+            add_clause(formula.begin(i), formula.end(i));
+    }
+
+    cdcl_solver_t(const cdcl_solver_t&) = delete;
+    cdcl_solver_t& operator=(const cdcl_solver_t&) = delete;
+
+    ~cdcl_solver_t() {
+        free(variable_assignments);
+        free(variable_decision_level);
+        free(variable_priority);
+        free(variable_activity);
+        free(variable_saved_phase);
+        free(variable_best_phase);
+    }
+
+    //  Add a variable and return it.
+    int new_variable() {
+        resize_variables(no_of_variables + 1);
+        return static_cast<int>(no_of_variables);
+    }
+
+    unsigned variables() const {
+        return no_of_variables;
+    }
+
+    //Input :   A clause; variables beyond those there are get added.
+    //
+    //Output:   Add it to the formula: repeated literals and those false at
+    //          decision level 0 are dropped, tautologies and clauses true
+    //          there skipped, and a unit is assigned and propagated at once.
+    //          Returns false if the formula has become unsatisfiable.
+    bool add_clause(const int* begin, const int* end) {
+        if (unsatisfiable)
+            return false;
+        for (const int* a = begin; a != end; a++)
+            resize_variables(abs(*a));
+        std::vector<int>& clause = clause_buffer;
+        clause.clear();
+        bool satisfied = false;
+        for (const int* a = begin; a != end; a++) {
+            unsigned variable = abs(*a);
+            if (variable_assignments[variable] == *a
+                    || seen[variable] == (*a > 0 ? 2 : 1)) {
+                satisfied = true;
+            } else if (variable_assignments[variable] == 0
+                    && seen[variable] == 0) {
+                seen[variable] = *a > 0 ? 1 : 2;
+                clause.push_back(*a);
+            }
+        }
+        for (auto a : clause)
+            seen[abs(a)] = 0;
+        if (satisfied)
+            return true;
+        if (clause.empty()) {
+            unsatisfiable = true;
+        } else if (clause.size() == 1) {
+            clause_ref_t unsat_clause;
+            assign_literal(clause[0], 0, null_clause);
+            if (!unit_propagate(0, unsat_clause))
+                unsatisfiable = true;
+        } else {
+            clause_ref_t ref = clause_arena.alloc(clause);
+            attach_clause(ref);
+            sat_instance.push_back(ref);
+        }
+        if (unsatisfiable && proof)
+            proof->add_empty();
+        return !unsatisfiable;
+    }
+
+    bool add_clause(const std::vector<int>& clause) {
+        return add_clause(clause.data(), clause.data() + clause.size());
+    }
+
+    //Input :   Literals to assume true, over variables that get added if
+    //          need be, and a no. of conflicts after which to give up, 0 for
+    //          no limit.
+    //
+    //Output:   Search for a model in which the assumptions hold; everything
+    //          learnt is kept for later calls, which may come after more
+    //          variables and clauses were added.  Returns result_unsat if
+    //          there is no such model, for any assumptions if proved_unsat(),
+    //          and result_unknown if the conflict limit was hit or the
+    //          portfolio stopped first.
+    result_t solve(const std::vector<int>& assumptions = std::vector<int>(),
+                   unsigned long conflict_limit = 0) {
+        conflict_assumptions.clear();
+        if (unsatisfiable)
+            return result_unsat;
+        for (auto a : assumptions)
+            resize_variables(abs(a));
+        result_t result = search(assumptions, conflict_limit);
+        if (result == result_sat)
+            model_assignments.assign(variable_assignments,
+                                     variable_assignments + no_of_variables + 1);
+        backtrack(0);
+        return result;
+    }
+
+    //  Counters of everything done since the solver was made.
+    cdcl_statistics_t statistics() const {
+        cdcl_statistics_t counted = stats;
+        counted.conflicts = no_of_conflicts;
+        return counted;
+    }
+
+    //  Keep a variable removed by preprocessing out of the search.
+    void set_eliminated(unsigned variable) {
+        if (!variable_eliminated[variable]) {
+            variable_eliminated[variable] = 1;
+            no_of_variables_eliminated++;
+        }
+    }
+
+    //  Log the proof of what follows to the writer; clauses learnt by other
+    //  workers are not in it, so this excludes share_clauses().
+    void write_proof(drat_writer_t* proof) {
+        this->proof = proof;
+        if (unsatisfiable && proof)
+            proof->add_empty();
+    }
+
+    //  Take part in a portfolio as the given worker.
+    void share_clauses(clause_exchange_t* exchange, unsigned worker) {
+        this->exchange = exchange;
+        this->worker = worker;
+    }
+
+    //  Assignment of every variable, as its true literal, after solve()
+    //  returned result_sat; 0 for eliminated variables.
+    const std::vector<int>& model() const {
+        return model_assignments;
+    }
+
+    //  After solve() returned result_unsat, the assumptions that cannot hold
+    //  together, none if the formula has no model at all.
+    const std::vector<int>& final_conflict() const {
+        return conflict_assumptions;
+    }
+
+    //  True if the assumption is part of the final conflict.
+    bool failed(int assumption) const {
+        return std::find(conflict_assumptions.begin(),
+                         conflict_assumptions.end(), assumption)
+                != conflict_assumptions.end();
+    }
+
+    //  True once the formula has been found unsatisfiable without any
+    //  assumptions.
+    bool proved_unsat() const {
+        return unsatisfiable;
+    }
+
+    //Input :   Literals assumed in the last solve().
+    //
+    //Output:   The variable of highest activity that is neither fixed at
+    //          decision level 0, eliminated nor assumed, 0 if none is left;
+    //          a cube the solver could not decide is split on it.
+    unsigned branch_variable(const std::vector<int>& assumptions) {
+        for (auto a : assumptions)
+            seen[abs(a)] = 1;
+        unsigned best = 0;
+        for (unsigned i = 1; i <= no_of_variables; i++) {
+            if (seen[i] || variable_eliminated[i]
+                    || variable_decision_level[i] == 0)
+                continue;
+            if (!best || variable_activity[i] > variable_activity[best])
+                best = i;
+        }
+        for (auto a : assumptions)
+            seen[abs(a)] = 0;
+        return best;
+    }
+};
+
+#endif //CDCL_H_
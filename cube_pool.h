@@ -0,0 +1,81 @@
+//============================================================================
+// Name        : cube_pool.h
+// Author      : Akash Banerjee (CS18MTECH11023)
+// Description : Work-stealing pool of cubes in C++11, Ansi-style
+//               Shared by the parallel modes of the solvers: a cube is a
+//               conjunction of literals, a piece of the search space that
+//               a worker solves, or splits into more cubes.
+//============================================================================
+
+#ifndef CUBE_POOL_H_
+#define CUBE_POOL_H_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//  Cubes still to be solved, one deque per worker.  A worker takes the
+//  newest cube of its own deque and, once that runs dry, steals the oldest
+//  of another's: neighbouring cubes, which share most of their literals,
+//  tend to stay with one solver, and a thief gets the largest piece of
+//  work there is.
+class cube_pool_t {
+    struct queue_t {
+        std::mutex lock;
+        std::deque<std::vector<int>> cubes;
+    };
+
+    std::vector<std::unique_ptr<queue_t>> queues;
+    //  Cubes pushed and not yet finished, those being solved included.
+    std::atomic<unsigned long> unfinished { 0 };
+
+ public:
+    explicit cube_pool_t(unsigned no_of_workers) {
+        for (unsigned i = 0; i < no_of_workers; i++)
+            queues.emplace_back(new queue_t);
+    }
+
+    void push(unsigned worker, std::vector<int> cube) {
+        unfinished++;
+        std::lock_guard<std::mutex> guard(queues[worker]->lock);
+        queues[worker]->cubes.push_back(std::move(cube));
+    }
+
+    //  Done with a cube taken, after pushing any cubes split off it.
+    void finish() {
+        unfinished--;
+    }
+
+    //Input :   A worker, a reference to return a cube in, and the flag
+    //          that stops the workers.
+    //
+    //Output:   Take a cube for the worker, waiting while others may still
+    //          split theirs; returns false once every cube is finished or
+    //          the workers are stopped.
+    bool take(unsigned worker, std::vector<int>& cube,
+              const std::atomic<bool>& stop) {
+        while (unfinished.load() > 0 && !stop.load(std::memory_order_relaxed)) {
+            for (unsigned i = 0; i < queues.size(); i++) {
+                queue_t& queue = *queues[(worker + i) % queues.size()];
+                std::lock_guard<std::mutex> guard(queue.lock);
+                if (queue.cubes.empty())
+                    continue;
+                if (i == 0) {
+                    cube = std::move(queue.cubes.back());
+                    queue.cubes.pop_back();
+                } else {
+                    cube = std::move(queue.cubes.front());
+                    queue.cubes.pop_front();
+                }
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        return false;
+    }
+};
+
+#endif //CUBE_POOL_H_
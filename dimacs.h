@@ -0,0 +1,731 @@
+//============================================================================
+// Name        : dimacs.h
+// Author      : Akash Banerjee (CS18MTECH11023)
+// Description : DIMACS CNF reader shared by all the solvers, Ansi-style
+//               Reads a file through mmap, or stdin in large chunks, and
+//               tokenizes it by hand straight into a flat literal buffer.
+//               Comments ('c' up to the end of the line) are allowed
+//               anywhere a token may start, and '%' ends the input.
+//               gzip, xz and bzip2 compressed input, recognised by its
+//               magic bytes, is decompressed chunk by chunk while parsing.
+//               Parsed instances can be cached in a binary sidecar file
+//               that later runs map into memory instead of re-parsing.
+//============================================================================
+
+// Compile with '-DUSE_ZLIB' and link '-lz' to read .cnf.gz inputs,
+// '-DUSE_LZMA' and '-llzma' for .cnf.xz, '-DUSE_BZIP2' and '-lbz2' for .cnf.bz2.
+
+#ifndef DIMACS_H_
+#define DIMACS_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif //USE_ZLIB
+#ifdef USE_LZMA
+#include <lzma.h>
+#endif //USE_LZMA
+#ifdef USE_BZIP2
+#include <bzlib.h>
+#endif //USE_BZIP2
+
+//  A CNF formula with the literals of all clauses stored back to back;
+//  clause i spans literals[clause_offsets[i]] to literals[clause_offsets[i + 1]].
+//  An instance loaded from a binary cache leaves both vectors empty and
+//  points into the mapped file instead.
+struct dimacs_instance_t {
+    unsigned no_of_variables = 0;
+    unsigned no_of_clauses = 0;
+    std::vector<int> literals;
+    std::vector<uint64_t> clause_offsets { 0 };
+    const int* mapped_literals = nullptr;
+    const uint64_t* mapped_offsets = nullptr;
+    std::shared_ptr<const void> mapping;
+
+    const int* literal_data() const {
+        return mapping ? mapped_literals : literals.data();
+    }
+
+    const uint64_t* offset_data() const {
+        return mapping ? mapped_offsets : clause_offsets.data();
+    }
+
+    size_t no_of_literals() const {
+        return offset_data()[no_of_clauses];
+    }
+
+    const int* begin(unsigned clause) const {
+        return literal_data() + offset_data()[clause];
+    }
+
+    const int* end(unsigned clause) const {
+        return literal_data() + offset_data()[clause + 1];
+    }
+
+    unsigned size(unsigned clause) const {
+        return static_cast<unsigned>(offset_data()[clause + 1]
+                - offset_data()[clause]);
+    }
+};
+
+//  Raw DIMACS text, handed out in chunks.
+class dimacs_source_t {
+ public:
+    virtual ~dimacs_source_t() {
+    }
+
+    //  Make the next chunk available as [begin, end), false at end of input.
+    virtual bool next_chunk(const char*& begin, const char*& end) = 0;
+
+    //  True if the input ended because it was corrupt or truncated.
+    virtual bool failed() const {
+        return false;
+    }
+};
+
+//  A whole regular file mapped into memory as a single chunk.
+class mmap_source_t : public dimacs_source_t {
+    void* data = MAP_FAILED;
+    size_t size = 0;
+    bool done = false;
+
+ public:
+    explicit mmap_source_t(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = static_cast<size_t>(st.st_size);
+            data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+                madvise(data, size, MADV_SEQUENTIAL);
+        }
+    }
+
+    ~mmap_source_t() {
+        if (data != MAP_FAILED)
+            munmap(data, size);
+    }
+
+    bool ok() const {
+        return data != MAP_FAILED;
+    }
+
+    const char* bytes() const {
+        return static_cast<const char*>(data);
+    }
+
+    size_t length() const {
+        return size;
+    }
+
+    bool next_chunk(const char*& begin, const char*& end) override {
+        if (done || data == MAP_FAILED)
+            return false;
+        done = true;
+        begin = static_cast<const char*>(data);
+        end = begin + size;
+        return true;
+    }
+};
+
+//  Any other descriptor, e.g. a pipe, read through a large buffer.
+class fd_source_t : public dimacs_source_t {
+    int fd;
+    std::vector<char> buffer;
+
+ public:
+    explicit fd_source_t(int fd, size_t buffer_size = 1 << 20)
+            : fd { fd },
+              buffer(buffer_size) {
+    }
+
+    bool next_chunk(const char*& begin, const char*& end) override {
+        ssize_t n;
+        do {
+            n = read(fd, buffer.data(), buffer.size());
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0)
+            return false;
+        begin = buffer.data();
+        end = begin + n;
+        return true;
+    }
+};
+
+//  Base of the decompressing sources: compressed chunks are pulled from
+//  input, starting with the already read [pending, pending_end), and
+//  inflated into a buffer of their own one chunk at a time, so the
+//  decompressed text is never held in memory as a whole.
+class decompressing_source_t : public dimacs_source_t {
+ protected:
+    std::unique_ptr<dimacs_source_t> input;
+    const char* pending;
+    const char* pending_end;
+    std::vector<char> buffer;
+    bool input_done = false;
+    bool finished = false;
+    bool error = false;
+
+    //  Make sure there is compressed input left, false once it ran out.
+    bool fill() {
+        while (pending == pending_end && !input_done) {
+            if (!input->next_chunk(pending, pending_end))
+                input_done = true;
+        }
+        return pending != pending_end;
+    }
+
+ public:
+    decompressing_source_t(std::unique_ptr<dimacs_source_t> input,
+                           const char* pending, const char* pending_end,
+                           size_t buffer_size = 1 << 20)
+            : input(std::move(input)),
+              pending { pending },
+              pending_end { pending_end },
+              buffer(buffer_size) {
+    }
+
+    bool failed() const override {
+        return error || input->failed();
+    }
+};
+
+#ifdef USE_ZLIB
+class gzip_source_t : public decompressing_source_t {
+    z_stream stream;
+
+ public:
+    gzip_source_t(std::unique_ptr<dimacs_source_t> input, const char* pending,
+                  const char* pending_end)
+            : decompressing_source_t(std::move(input), pending, pending_end) {
+        memset(&stream, 0, sizeof(stream));
+        error = inflateInit2(&stream, 15 + 32) != Z_OK;
+        finished = error;
+    }
+
+    ~gzip_source_t() {
+        inflateEnd(&stream);
+    }
+
+    bool next_chunk(const char*& begin, const char*& end) override {
+        while (!finished) {
+            if (!fill()) {
+                error = true;
+                return false;
+            }
+            stream.next_in = (Bytef*) pending;
+            stream.avail_in = static_cast<uInt>(std::min<size_t>(
+                    pending_end - pending, UINT_MAX));
+            stream.next_out = (Bytef*) buffer.data();
+            stream.avail_out = static_cast<uInt>(buffer.size());
+            int ret = inflate(&stream, Z_NO_FLUSH);
+            pending = (const char*) stream.next_in;
+            if (ret == Z_STREAM_END) {
+                //  Concatenated gzip members continue the same text.
+                if (fill())
+                    inflateReset(&stream);
+                else
+                    finished = true;
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                error = finished = true;
+                return false;
+            }
+            size_t produced = buffer.size() - stream.avail_out;
+            if (produced) {
+                begin = buffer.data();
+                end = begin + produced;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+#endif //USE_ZLIB
+
+#ifdef USE_LZMA
+class xz_source_t : public decompressing_source_t {
+    lzma_stream stream = LZMA_STREAM_INIT;
+
+ public:
+    xz_source_t(std::unique_ptr<dimacs_source_t> input, const char* pending,
+                const char* pending_end)
+            : decompressing_source_t(std::move(input), pending, pending_end) {
+        error = lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED)
+                != LZMA_OK;
+        finished = error;
+    }
+
+    ~xz_source_t() {
+        lzma_end(&stream);
+    }
+
+    bool next_chunk(const char*& begin, const char*& end) override {
+        while (!finished) {
+            fill();
+            stream.next_in = (const uint8_t*) pending;
+            stream.avail_in = pending_end - pending;
+            stream.next_out = (uint8_t*) buffer.data();
+            stream.avail_out = buffer.size();
+            lzma_ret ret = lzma_code(&stream,
+                                     input_done ? LZMA_FINISH : LZMA_RUN);
+            pending = (const char*) stream.next_in;
+            if (ret == LZMA_STREAM_END) {
+                finished = true;
+            } else if (ret != LZMA_OK) {
+                error = finished = true;
+                return false;
+            }
+            size_t produced = buffer.size() - stream.avail_out;
+            if (produced) {
+                begin = buffer.data();
+                end = begin + produced;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+#endif //USE_LZMA
+
+#ifdef USE_BZIP2
+class bz2_source_t : public decompressing_source_t {
+    bz_stream stream;
+
+ public:
+    bz2_source_t(std::unique_ptr<dimacs_source_t> input, const char* pending,
+                 const char* pending_end)
+            : decompressing_source_t(std::move(input), pending, pending_end) {
+        memset(&stream, 0, sizeof(stream));
+        error = BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK;
+        finished = error;
+    }
+
+    ~bz2_source_t() {
+        BZ2_bzDecompressEnd(&stream);
+    }
+
+    bool next_chunk(const char*& begin, const char*& end) override {
+        while (!finished) {
+            if (!fill()) {
+                error = true;
+                return false;
+            }
+            stream.next_in = const_cast<char*>(pending);
+            stream.avail_in = static_cast<unsigned>(std::min<size_t>(
+                    pending_end - pending, UINT_MAX));
+            stream.next_out = buffer.data();
+            stream.avail_out = static_cast<unsigned>(buffer.size());
+            int ret = BZ2_bzDecompress(&stream);
+            pending = stream.next_in;
+            if (ret == BZ_STREAM_END) {
+                //  As do concatenated bzip2 streams, e.g. from pbzip2.
+                BZ2_bzDecompressEnd(&stream);
+                if (!fill() || BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK)
+                    finished = true;
+            } else if (ret != BZ_OK) {
+                error = finished = true;
+                return false;
+            }
+            size_t produced = buffer.size() - stream.avail_out;
+            if (produced) {
+                begin = buffer.data();
+                end = begin + produced;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+#endif //USE_BZIP2
+
+class dimacs_parser_t {
+    dimacs_source_t& source;
+    const char* position = nullptr;
+    const char* end = nullptr;
+
+    int peek() {
+        if (position == end && !source.next_chunk(position, end))
+            return EOF;
+        return static_cast<unsigned char>(*position);
+    }
+
+    void skip_line() {
+        int c;
+        while ((c = peek()) != EOF) {
+            position++;
+            if (c == '\n')
+                return;
+        }
+    }
+
+    void skip_blanks() {
+        int c;
+        while ((c = peek()) == ' ' || c == '\t' || c == '\r')
+            position++;
+    }
+
+    bool parse_unsigned(unsigned long& value) {
+        int c = peek();
+        if (c < '0' || c > '9')
+            return false;
+        value = 0;
+        while ((c = peek()) >= '0' && c <= '9') {
+            value = value * 10 + static_cast<unsigned>(c - '0');
+            if (value > INT_MAX)
+                return false;
+            position++;
+        }
+        return true;
+    }
+
+    bool parse_header(dimacs_instance_t& instance) {
+        position++;
+        skip_blanks();
+        for (const char* a = "cnf"; *a; a++) {
+            if (peek() != *a)
+                return false;
+            position++;
+        }
+        unsigned long variables, clauses;
+        skip_blanks();
+        if (!parse_unsigned(variables))
+            return false;
+        skip_blanks();
+        if (!parse_unsigned(clauses))
+            return false;
+        if (variables > UINT_MAX)
+            return false;
+        //  A header may follow clauses, e.g. in concatenated gzip members,
+        //  so it must not lower the largest variable seen so far.
+        if (variables > instance.no_of_variables)
+            instance.no_of_variables = static_cast<unsigned>(variables);
+        //  The clause count is only a hint: a clause or a literal takes at
+        //  least two bytes, so reserve no more than the input at hand, the
+        //  rest of the file when it is mapped, can hold.
+        size_t hint = static_cast<size_t>(end - position) / 2;
+        instance.clause_offsets.reserve(
+                instance.clause_offsets.size()
+                + std::min<size_t>(clauses, hint) + 1);
+        instance.literals.reserve(instance.literals.size()
+                + std::min<size_t>(clauses * 3, hint));
+        return true;
+    }
+
+ public:
+    explicit dimacs_parser_t(dimacs_source_t& source,
+                             const char* position = nullptr,
+                             const char* end = nullptr)
+            : source(source),
+              position { position },
+              end { end } {
+    }
+
+    bool parse(dimacs_instance_t& instance) {
+        int c;
+        while ((c = peek()) != EOF && c != '%') {
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                position++;
+            } else if (c == 'c') {
+                skip_line();
+            } else if (c == 'p') {
+                if (!parse_header(instance))
+                    return false;
+            } else {
+                bool negative = c == '-';
+                if (negative)
+                    position++;
+                unsigned long variable;
+                if (!parse_unsigned(variable))
+                    return false;
+                if (variable == 0) {
+                    instance.clause_offsets.push_back(instance.literals.size());
+                    continue;
+                }
+                if (variable > instance.no_of_variables)
+                    instance.no_of_variables = static_cast<unsigned>(variable);
+                instance.literals.push_back(
+                        negative ? -static_cast<int>(variable) :
+                                   static_cast<int>(variable));
+            }
+        }
+        if (instance.literals.size() != instance.clause_offsets.back())
+            instance.clause_offsets.push_back(instance.literals.size());
+        instance.no_of_clauses = static_cast<unsigned>(
+                instance.clause_offsets.size() - 1);
+        return true;
+    }
+};
+
+enum compression_t {
+    compression_none, compression_gzip, compression_xz, compression_bzip2
+};
+
+//Input :   The first bytes of the input.
+//
+//Output:   The compression format their magic number identifies.
+inline compression_t detect_compression(const char* begin, const char* end) {
+    size_t size = end - begin;
+    if (size >= 2 && memcmp(begin, "\x1f\x8b", 2) == 0)
+        return compression_gzip;
+    if (size >= 6 && memcmp(begin, "\xfd" "7zXZ\0", 6) == 0)
+        return compression_xz;
+    if (size >= 3 && memcmp(begin, "BZh", 3) == 0)
+        return compression_bzip2;
+    return compression_none;
+}
+
+//  Binary CNF file: this header, then no_of_clauses + 1 clause offsets
+//  (uint64_t), then the packed literals (int32_t), all in native byte
+//  order. Every section starts 8-byte aligned, so a mapped file can be
+//  used in place.
+struct binary_cnf_header_t {
+    char magic[8];
+    uint64_t source_hash;       //  Of the text the file was built from.
+    uint64_t source_size;
+    uint64_t no_of_literals;
+    uint32_t no_of_variables;
+    uint32_t no_of_clauses;
+    uint32_t byte_order;
+    uint32_t reserved;
+};
+
+static const char binary_cnf_magic[8] = { '\x7f', 'C', 'N', 'F', 'B', 'I', 'N',
+        '\x01' };
+static const uint32_t binary_cnf_byte_order = 0x01020304;
+
+inline bool is_binary_cnf(const char* begin, const char* end) {
+    return static_cast<size_t>(end - begin) >= sizeof(binary_cnf_magic)
+            && memcmp(begin, binary_cnf_magic, sizeof(binary_cnf_magic)) == 0;
+}
+
+//Input :   The bytes of a file.
+//
+//Output:   A 64 bit hash of them, computed a word at a time so that
+//          hashing costs far less than parsing.
+inline uint64_t hash_bytes(const char* begin, const char* end) {
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(end - begin);
+    for (; end - begin >= 8; begin += 8) {
+        uint64_t word;
+        memcpy(&word, begin, 8);
+        hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    for (; begin != end; begin++)
+        hash = (hash ^ static_cast<unsigned char>(*begin)) * 0x100000001b3ULL;
+    hash ^= hash >> 29;
+    return hash * 0xc4ceb9fe1a85ec53ULL;
+}
+
+//Input :   A mapped binary CNF file, the instance to point into it, and
+//          the hash and size of the text it must have been built from,
+//          or nullptr to accept any.
+//
+//Output:   Returns false, leaving the instance untouched, if the file is
+//          not a well formed binary CNF built from that text. Offsets and
+//          literals are range checked so a corrupt file cannot make the
+//          solvers index out of bounds.
+inline bool map_binary_cnf(std::shared_ptr<mmap_source_t> file,
+                           dimacs_instance_t& instance,
+                           const uint64_t* source_hash = nullptr,
+                           uint64_t source_size = 0) {
+    binary_cnf_header_t header;
+    if (!file->ok() || file->length() < sizeof(header))
+        return false;
+    memcpy(&header, file->bytes(), sizeof(header));
+    if (!is_binary_cnf(header.magic, header.magic + sizeof(header.magic))
+            || header.byte_order != binary_cnf_byte_order)
+        return false;
+    if (source_hash
+            && (header.source_hash != *source_hash
+                    || header.source_size != source_size))
+        return false;
+    uint64_t offsets_size = (uint64_t(header.no_of_clauses) + 1)
+            * sizeof(uint64_t);
+    if (header.no_of_literals > (file->length() - sizeof(header)) / sizeof(int)
+            || file->length()
+                    != sizeof(header) + offsets_size
+                            + header.no_of_literals * sizeof(int))
+        return false;
+
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(file->bytes()
+            + sizeof(header));
+    const int* literals = reinterpret_cast<const int*>(file->bytes()
+            + sizeof(header) + offsets_size);
+    if (offsets[0] != 0 || offsets[header.no_of_clauses] != header.no_of_literals)
+        return false;
+    for (uint32_t i = 0; i < header.no_of_clauses; i++)
+        if (offsets[i] > offsets[i + 1])
+            return false;
+    int max_variable = static_cast<int>(std::min<uint32_t>(
+            header.no_of_variables, INT_MAX));
+    for (uint64_t i = 0; i < header.no_of_literals; i++)
+        if (literals[i] == 0 || literals[i] < -max_variable
+                || literals[i] > max_variable)
+            return false;
+
+    instance.no_of_variables = header.no_of_variables;
+    instance.no_of_clauses = header.no_of_clauses;
+    instance.literals.clear();
+    instance.clause_offsets.clear();
+    instance.mapped_offsets = offsets;
+    instance.mapped_literals = literals;
+    instance.mapping = std::move(file);
+    return true;
+}
+
+//Input :   Path to write to, a parsed instance, and the hash and size of
+//          the text it was parsed from.
+//
+//Output:   Writes the instance as a binary CNF file, through a temporary
+//          file renamed into place so that a concurrent reader never sees
+//          a partial one. Returns false if it could not be written.
+inline bool write_binary_cnf(const std::string& path,
+                             const dimacs_instance_t& instance,
+                             uint64_t source_hash, uint64_t source_size) {
+    binary_cnf_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, binary_cnf_magic, sizeof(header.magic));
+    header.source_hash = source_hash;
+    header.source_size = source_size;
+    header.no_of_literals = instance.no_of_literals();
+    header.no_of_variables = instance.no_of_variables;
+    header.no_of_clauses = instance.no_of_clauses;
+    header.byte_order = binary_cnf_byte_order;
+
+    std::string temporary = path + ".tmp." + std::to_string(getpid());
+    FILE* out = fopen(temporary.c_str(), "wb");
+    if (!out)
+        return false;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1
+            && fwrite(instance.offset_data(), sizeof(uint64_t),
+                      instance.no_of_clauses + 1, out)
+                    == instance.no_of_clauses + 1
+            && fwrite(instance.literal_data(), sizeof(int),
+                      header.no_of_literals, out) == header.no_of_literals;
+    ok = fclose(out) == 0 && ok;
+    if (ok)
+        ok = rename(temporary.c_str(), path.c_str()) == 0;
+    if (!ok)
+        unlink(temporary.c_str());
+    return ok;
+}
+
+//Input :   Path of a DIMACS file, or nullptr to read stdin, the instance
+//          to fill, and whether to use a binary sidecar cache.
+//
+//Output:   Returns false if the input cannot be opened, is malformed, or
+//          is compressed in a format this build cannot decompress.
+//          Regular files, including stdin redirected from one, are
+//          mmapped; anything else is read in chunks. A binary CNF file
+//          is mapped and used in place. With use_cache, a named regular
+//          file is looked up in "<path>.cnfbin" by the hash of its
+//          contents, and on a miss that file is (re)written after parsing;
+//          failing to write it is not an error.
+inline bool read_dimacs(const char* path, dimacs_instance_t& instance,
+                        bool use_cache = false) {
+    int fd = path ? open(path, O_RDONLY) : STDIN_FILENO;
+    if (fd < 0)
+        return false;
+    std::unique_ptr<dimacs_source_t> source;
+    std::unique_ptr<mmap_source_t> mapped;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        mapped.reset(new mmap_source_t(fd));
+        if (!mapped->ok() && st.st_size != 0)
+            mapped.reset();
+    }
+    bool is_mapped = mapped != nullptr;
+    if (is_mapped)
+        source = std::move(mapped);
+    else
+        source.reset(new fd_source_t(fd));
+
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    source->next_chunk(begin, end);
+    if (is_binary_cnf(begin, end)) {
+        bool ok = false;
+        if (is_mapped) {
+            std::shared_ptr<mmap_source_t> file {
+                    static_cast<mmap_source_t*>(source.release()) };
+            ok = map_binary_cnf(std::move(file), instance);
+        } else {
+            fprintf(stderr, "A binary CNF file can only be read from a"
+                    " regular file\n");
+        }
+        if (path)
+            close(fd);
+        return ok;
+    }
+
+    //  A mapped file is a single chunk, so its hash is known up front.
+    std::string cache_path;
+    uint64_t hash = 0;
+    size_t size = end - begin;
+    if (use_cache && path && is_mapped) {
+        hash = hash_bytes(begin, end);
+        cache_path = std::string(path) + ".cnfbin";
+        int cache_fd = open(cache_path.c_str(), O_RDONLY);
+        if (cache_fd >= 0) {
+            std::shared_ptr<mmap_source_t> cache { new mmap_source_t(cache_fd) };
+            close(cache_fd);
+            if (map_binary_cnf(std::move(cache), instance, &hash, size)) {
+                close(fd);
+                return true;
+            }
+        }
+    }
+
+    switch (detect_compression(begin, end)) {
+    case compression_none:
+        break;
+#ifdef USE_ZLIB
+    case compression_gzip:
+        source.reset(new gzip_source_t(std::move(source), begin, end));
+        begin = end = nullptr;
+        break;
+#endif //USE_ZLIB
+#ifdef USE_LZMA
+    case compression_xz:
+        source.reset(new xz_source_t(std::move(source), begin, end));
+        begin = end = nullptr;
+        break;
+#endif //USE_LZMA
+#ifdef USE_BZIP2
+    case compression_bzip2:
+        source.reset(new bz2_source_t(std::move(source), begin, end));
+        begin = end = nullptr;
+        break;
+#endif //USE_BZIP2
+    default:
+        fprintf(stderr, "Compressed input, but this build cannot read it;"
+                " see the flags at the top of dimacs.h\n");
+        source.reset();
+        if (path)
+            close(fd);
+        return false;
+    }
+    bool ok = dimacs_parser_t(*source, begin, end).parse(instance)
+            && !source->failed();
+    source.reset();
+    if (path)
+        close(fd);
+    if (ok && !cache_path.empty())
+        write_binary_cnf(cache_path, instance, hash, size);
+    return ok;
+}
+
+#endif /* DIMACS_H_ */
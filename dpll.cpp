@@ -3,44 +3,69 @@
 // Author      : Akash Banerjee (cs18mtech11023@iith.ac.in)
 // Description : DPLL Sat Solver in C++11, Ansi-style
 //               Input  a  sat  instance  in  the  simplified  DIMACS  format
-//               through stdin  and  output either UNSAT or SAT followed by a
-//               satisfying  assignment on  the next line in  minisat2 format.
+//               through stdin, or the file named on the command line,  and
+//               output either UNSAT or SAT followed by a satisfying
+//               assignment on  the next line in  minisat2 format.
+//               With --threads=N the top of the search tree is split into
+//               cubes that N solvers, one per thread, share by work
+//               stealing.  With --count it outputs the no. of models
+//               instead, counting the components of the formula left by
+//               each branch apart and caching their counts.
 //============================================================================
 
+// Compile with '-pthread' for --threads.
+// Compile with '-DUSE_GMP' and link '-lgmpxx -lgmp' to count with GMP
+// integers instead of the ones below.
+
+#include <atomic>
 #include <iostream>
 #include <limits>
+#include <list>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <bits/stdc++.h>
 
+#ifdef USE_GMP
+#include <gmpxx.h>
+#endif //USE_GMP
+
+#include "cube_pool.h"
+#include "dimacs.h"
+
 typedef std::vector<int> clause_t;
 typedef std::vector<clause_t> sat_instance_t;
 
 static unsigned no_of_variables;
 static unsigned no_of_clauses;
 
+//  pick_literal() keeps per-variable occurrence counts for unsatisfied
+//  clauses of up to moms_sizes literals left; should all of them be longer
+//  it counts by scanning the formula.
+static const unsigned moms_sizes = 16;
+
+//  With --threads a cube is split in two, on the literal pick_literal()
+//  chooses, until it has cutoff_depth literals; deeper subtrees are
+//  searched by one solver.
+static unsigned cutoff_depth = 10;
+
+//  With --count, the most memory the component cache may take.
+static size_t cache_bytes = size_t(256) << 20;
+
 inline bool absolute_comparator(int i, int j);
-inline unsigned max(unsigned i, unsigned j);
+inline unsigned literal_index(int literal);
 void print_sat_instance(const sat_instance_t& sat_instance);
-void initialize_sat_instance(sat_instance_t& sat_instance);
+bool initialize_sat_instance(sat_instance_t& sat_instance, const char* path);
 inline bool has_empty_clause(const sat_instance_t& sat_instance);
-inline int pick_literal(const sat_instance_t& sat_instance);
-unsigned assign_literal(sat_instance_t& sat_instance, int literal);
-unsigned assign_literal(sat_instance_t& sat_instance, int literal,
-                        std::vector<int>& new_unit_clauses);
-unsigned unit_clause_removal(sat_instance_t& sat_instance);
-unsigned unit_clause_removal(sat_instance_t& sat_instance,
-                             std::vector<int>& literals_assigned);
-bool dpll(sat_instance_t& sat_instance,
-          std::vector<int>& satisfying_assignment);
 
 //  Comparator for output sorted on absolute value.
 inline bool absolute_comparator(int i, int j) {
     return abs(i) < abs(j);
 }
 
-//  Returns max of two integers.
-inline unsigned max(unsigned i, unsigned j) {
-    return i > j ? i : j;
+//  Index of a literal in per-literal arrays: 2v for v, 2v + 1 for -v.
+inline unsigned literal_index(int literal) {
+    return (static_cast<unsigned>(abs(literal)) << 1) | (literal < 0);
 }
 
 //Input :   A sat_instance.
@@ -57,39 +82,32 @@ void print_sat_instance(const sat_instance_t& sat_instance) {
     }
 }
 
-//Input :   Reference to a sat_instance.
+//Input :   Reference to a sat_instance, and the path of the DIMACS
+//          input, nullptr for stdin.
 //
-//Output:   Initialize the  provided   sat_instance
-//          and also return the number of variables.
-void initialize_sat_instance(sat_instance_t& sat_instance) {
-    char a;
-    std::cin >> a;
-    while (a != 'p') {
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::cin >> a;
-    }
-    std::cin.ignore(5);
-    std::cin >> no_of_variables;
-    std::cin >> no_of_clauses;
-    sat_instance.reserve(no_of_clauses);
-    for (unsigned i = 0; i < no_of_clauses; i++) {
-        int literal;
-        clause_t clause;
-        std::cin.ignore(10, '\n');
-        while (true) {
-            std::cin >> literal;
-            if (!std::cin.good()) {
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
-                                '\n');
-                continue;
-            }
-            if (literal == 0)
-                break;
-            clause.push_back(literal);
-        }
-        sat_instance.push_back(clause);
+//Output:   Initialize the  provided   sat_instance  and  the number of
+//          variables; returns false if the input could not be read.
+//          Repeated literals are merged and tautologies dropped, so that
+//          every clause has distinct variables.
+bool initialize_sat_instance(sat_instance_t& sat_instance, const char* path) {
+    dimacs_instance_t instance;
+    if (!read_dimacs(path, instance))
+        return false;
+    no_of_variables = instance.no_of_variables;
+    sat_instance.reserve(instance.no_of_clauses);
+    for (unsigned i = 0; i < instance.no_of_clauses; i++) {
+        clause_t clause(instance.begin(i), instance.end(i));
+        std::sort(clause.begin(), clause.end(), absolute_comparator);
+        clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+        bool tautology = false;
+        for (size_t j = 1; j < clause.size(); j++)
+            if (clause[j] == -clause[j - 1])
+                tautology = true;
+        if (!tautology)
+            sat_instance.push_back(std::move(clause));
     }
+    no_of_clauses = static_cast<unsigned>(sat_instance.size());
+    return true;
 }
 
 //Input :   A sat_instance.
@@ -97,7 +115,7 @@ void initialize_sat_instance(sat_instance_t& sat_instance) {
 //Output:   Returns true if the sat_instance has
 //          an empty clause and false  otherwise.
 inline bool has_empty_clause(const sat_instance_t& sat_instance) {
-    for (auto a : sat_instance) {
+    for (auto& a : sat_instance) {
         if (a.empty())
             return true;
     }
@@ -105,276 +123,867 @@ inline bool has_empty_clause(const sat_instance_t& sat_instance) {
     return false;
 }
 
-//Input :   A sat_nstance.
-//
-//Output:   Find the Most Occuring variable in the Minimum Sized clause.
-int pick_literal(const sat_instance_t& sat_instance) {
+#ifdef USE_GMP
+//  A no. of models, as a GMP integer.
+class model_count_t {
+    mpz_class value;
+
+ public:
+    explicit model_count_t(uint32_t value = 0)
+            : value { static_cast<unsigned long>(value) } {
+    }
+
+    bool is_zero() const {
+        return value == 0;
+    }
 
-    unsigned *variable_count = new unsigned[no_of_variables + 1];
+    model_count_t& operator+=(const model_count_t& other) {
+        value += other.value;
+        return *this;
+    }
+
+    model_count_t& operator*=(const model_count_t& other) {
+        value *= other.value;
+        return *this;
+    }
+
+    //  Multiply by 2 to the given power.
+    model_count_t& operator<<=(unsigned bits) {
+        value <<= bits;
+        return *this;
+    }
+
+    std::string to_string() const {
+        return value.get_str();
+    }
+
+    size_t bytes() const {
+        return sizeof(*this) + mpz_size(value.get_mpz_t()) * sizeof(mp_limb_t);
+    }
+};
+#else
+//  A no. of models, of any size: base 2^32 digits, least significant
+//  first, with no leading zeros, so 0 has none.
+class model_count_t {
+    std::vector<uint32_t> limbs;
+
+    void trim() {
+        while (!limbs.empty() && limbs.back() == 0)
+            limbs.pop_back();
+    }
 
-    for (unsigned i = 0; i <= no_of_variables; i++)
-        variable_count[i] = 0;
+ public:
+    explicit model_count_t(uint32_t value = 0) {
+        if (value)
+            limbs.push_back(value);
+    }
 
-    sat_instance_t only_min_clauses;
-    unsigned min_clause_size =
-            static_cast<unsigned>(sat_instance.front().size());
+    bool is_zero() const {
+        return limbs.empty();
+    }
 
-    for (auto i : sat_instance) {
-        if (i.size() < min_clause_size) {
-            min_clause_size = static_cast<unsigned>(i.size());
-            only_min_clauses.clear();
-            only_min_clauses.push_back(i);
-        } else if (i.size() == min_clause_size) {
-            only_min_clauses.push_back(i);
+    model_count_t& operator+=(const model_count_t& other) {
+        if (limbs.size() < other.limbs.size())
+            limbs.resize(other.limbs.size());
+        uint64_t carry = 0;
+        for (size_t i = 0; i < limbs.size(); i++) {
+            carry += limbs[i];
+            if (i < other.limbs.size())
+                carry += other.limbs[i];
+            limbs[i] = static_cast<uint32_t>(carry);
+            carry >>= 32;
         }
+        if (carry)
+            limbs.push_back(static_cast<uint32_t>(carry));
+        return *this;
     }
 
-    for (auto i : only_min_clauses)
-        for (auto j : i)
-            variable_count[abs(j)]++;
+    model_count_t& operator*=(const model_count_t& other) {
+        if (is_zero() || other.is_zero()) {
+            limbs.clear();
+            return *this;
+        }
+        std::vector<uint32_t> product(limbs.size() + other.limbs.size());
+        for (size_t i = 0; i < limbs.size(); i++) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < other.limbs.size(); j++) {
+                carry += static_cast<uint64_t>(limbs[i]) * other.limbs[j]
+                        + product[i + j];
+                product[i + j] = static_cast<uint32_t>(carry);
+                carry >>= 32;
+            }
+            product[i + other.limbs.size()] = static_cast<uint32_t>(carry);
+        }
+        limbs.swap(product);
+        trim();
+        return *this;
+    }
 
-    unsigned max_occurrence = 0;
-    unsigned max_occurring_variable = 0;
-    for (unsigned i = 0; i <= no_of_variables; i++) {
-        if (variable_count[i] > max_occurrence) {
-            max_occurrence = variable_count[i];
-            max_occurring_variable = i;
+    //  Multiply by 2 to the given power.
+    model_count_t& operator<<=(unsigned bits) {
+        if (is_zero())
+            return *this;
+        unsigned shift = bits % 32;
+        if (shift) {
+            uint32_t carry = 0;
+            for (auto& a : limbs) {
+                uint32_t next = a >> (32 - shift);
+                a = (a << shift) | carry;
+                carry = next;
+            }
+            if (carry)
+                limbs.push_back(carry);
         }
+        limbs.insert(limbs.begin(), bits / 32, 0);
+        return *this;
     }
 
-    return static_cast<int>(max_occurring_variable);
+    //  In decimal, taken off nine digits at a time.
+    std::string to_string() const {
+        if (is_zero())
+            return "0";
+        std::vector<uint32_t> quotient = limbs;
+        std::string text;
+        while (!quotient.empty()) {
+            uint64_t remainder = 0;
+            for (size_t i = quotient.size(); i-- > 0;) {
+                uint64_t current = (remainder << 32) | quotient[i];
+                quotient[i] = static_cast<uint32_t>(current / 1000000000);
+                remainder = current % 1000000000;
+            }
+            while (!quotient.empty() && quotient.back() == 0)
+                quotient.pop_back();
+            for (unsigned i = 0; i < 9; i++) {
+                text.push_back(static_cast<char>('0' + remainder % 10));
+                remainder /= 10;
+                if (quotient.empty() && remainder == 0)
+                    break;
+            }
+        }
+        std::reverse(text.begin(), text.end());
+        return text;
+    }
 
-//    return sat_instance.front().front();
+    size_t bytes() const {
+        return sizeof(*this) + limbs.capacity() * sizeof(uint32_t);
+    }
+};
+#endif //USE_GMP
+
+//  Identifies a component of the formula left by an assignment: its
+//  variables, sorted, a 0, and its unsatisfied clauses, sorted, plus one.
+//  The clauses are false on every assigned literal, so this determines the
+//  component's formula wherever in the search it turns up.
+typedef std::vector<unsigned> component_key_t;
+
+//  Model counts of components, taking up at most a given no. of bytes;
+//  beyond that the least recently used are evicted.
+class component_cache_t {
+    struct key_hash_t {
+        size_t operator()(const component_key_t& key) const {
+            uint64_t hash = 14695981039346656037ull;
+            for (auto a : key)
+                hash = (hash ^ a) * 1099511628211ull;
+            return static_cast<size_t>(hash);
+        }
+    };
+    struct entry_t {
+        model_count_t count;
+        std::list<const component_key_t*>::iterator position;
+    };
+
+    std::unordered_map<component_key_t, entry_t, key_hash_t> entries;
+    //  Keys of the entries, most recently used first.
+    std::list<const component_key_t*> recency;
+    size_t bytes = 0;
+    size_t max_bytes;
+
+    //  Rough size of an entry, the hash table and list nodes included.
+    static size_t entry_bytes(const component_key_t& key,
+                              const model_count_t& count) {
+        return key.size() * sizeof(unsigned) + count.bytes() + 96;
+    }
 
-////    Try to combine MOMS with UnitPropagation for more accurate estimation.
-////
-//    unsigned max_unit_propagation = 0;
-//    int max_unit_propagation_literal = 0;
-//    for(int i = 0; i <= no_of_variables; i++){
-//        if(literals[i] == max_occurrence){
-//
-//            sat_instance_t branch_assignment = sat_instance;
-//            unsigned a = assign_literal(branch_assignment, i);
-//            a += unit_clause_removal(branch_assignment);
-//            if(has_empty_clause(branch_assignment)){
-//                a = 0;
-//            }
-//
-//            branch_assignment = sat_instance;
-//            unsigned b = assign_literal(branch_assignment, -i);
-//            b += unit_clause_removal(branch_assignment);
-//            if(has_empty_clause(branch_assignment)){
-//                b = 0;
-//            }
-//            if(max(a, b) > max_unit_propagation){
-//                max_unit_propagation = max(a, b);
-//                max_unit_propagation_literal = a>b?i:-i;
-//            }
-//        }
-//    }
-//    return max_unit_propagation_literal;
-}
+ public:
+    explicit component_cache_t(size_t max_bytes)
+            : max_bytes { max_bytes } {
+    }
 
-//Input :   Reference  to a sat instance, and  a  literal.
-//
-//Output:   Modify the sat_instance to remove all clauses
-//          where  that literal  is  present  and  remove
-//          the negation of that literal from all clauses
-//          and also return the number of clauses removed.
-unsigned assign_literal(sat_instance_t& sat_instance, int literal) {
-
-    unsigned no_of_clauses_removed = 0;
-
-    for (auto i = sat_instance.begin(); i < sat_instance.end(); i++) {
-        bool flag = false;
-        for (auto j = i->begin(); j < i->end(); j++) {
-            if (*j == (-literal)) {
-//                i->erase(j);
-                *j = std::move(i->back());
-                i->pop_back();
-                break;
-            } else if (*j == literal) {
-                flag = true;
-                break;
-            }
+    //  The count of the component, nullptr if it is not cached.
+    const model_count_t* find(const component_key_t& key) {
+        auto entry = entries.find(key);
+        if (entry == entries.end())
+            return nullptr;
+        recency.splice(recency.begin(), recency, entry->second.position);
+        return &entry->second.count;
+    }
+
+    void insert(const component_key_t& key, const model_count_t& count) {
+        auto inserted = entries.emplace(key, entry_t { count, recency.end() });
+        if (!inserted.second)
+            return;
+        size_t size = entry_bytes(key, inserted.first->second.count);
+        if (size > max_bytes) {
+            entries.erase(inserted.first);
+            return;
         }
-        if (flag) {
-            no_of_clauses_removed++;
-            *i = std::move(sat_instance.back());
-            sat_instance.pop_back();
-//            sat_instance.erase(i);
-            i--;
+        while (bytes + size > max_bytes) {
+            auto entry = entries.find(*recency.back());
+            bytes -= entry_bytes(entry->first, entry->second.count);
+            recency.pop_back();
+            entries.erase(entry);
         }
+        recency.push_front(&inserted.first->first);
+        inserted.first->second.position = recency.begin();
+        bytes += size;
+    }
+};
+
+//  DPLL over a formula that is never modified.  Assignments are kept on a
+//  trail, and every clause has counters of its true literals and of the
+//  literals not yet false, which assigning a literal updates only for the
+//  clauses it occurs in and backtracking restores.  So do the counts the
+//  branching heuristic reads.
+class dpll_solver_t {
+    const sat_instance_t& sat_instance;
+    //  occurrences[literal_index(l)] lists the clauses containing l.
+    std::vector<std::vector<unsigned>> occurrences;
+    std::vector<unsigned> true_literals;
+    std::vector<unsigned> free_literals;
+    unsigned no_of_satisfied_clauses = 0;
+
+    //  Value of each variable as its true literal, 0 if unassigned.
+    std::vector<int> assignments;
+    //  Literals in the order they were assigned; the counters account for
+    //  those before propagation_head.
+    std::vector<int> trail;
+    size_t propagation_head = 0;
+    //  Set for the variables of the literals before propagation_head; the
+    //  others are open.
+    std::vector<char> propagated;
+
+    //  clauses_of_size[s] is the no. of unsatisfied clauses with s open
+    //  literals, and for s up to moms_sizes, moms_count[v * moms_stride + s]
+    //  the no. of those in which variable v is open; the counts of one
+    //  variable are side by side, as a clause losing a literal moves its
+    //  variables from one size to the next.
+    std::vector<unsigned> clauses_of_size;
+    std::vector<unsigned> moms_count;
+    unsigned moms_stride;
+    std::vector<unsigned> variable_count;
+
+    //  The decisions in force, innermost last: the trail size before the
+    //  decision, the literal decided and whether it is the second branch.
+    struct decision_t {
+        size_t trail_size;
+        int literal;
+        bool flipped;
+    };
+    std::vector<decision_t> decisions;
+
+    //  The unit clauses of the formula, assigned by reset(), and whether
+    //  those, or the literals assumed since, contradict the formula.
+    std::vector<int> units;
+    bool empty_clause;
+    bool inconsistent = false;
+
+    //  Set when running in parallel; search() gives up once it is true.
+    const std::atomic<bool>* stop = nullptr;
+
+    //  For decompose(), the variables and clauses reached so far are those
+    //  stamped with the current stamp.
+    std::vector<unsigned> variable_stamp;
+    std::vector<unsigned> clause_stamp;
+    unsigned stamp = 0;
+
+    //  Open variables and the unsatisfied clauses over them, linked by the
+    //  clauses and sharing no variable with the rest of the formula.
+    struct component_t {
+        std::vector<unsigned> variables;
+        std::vector<unsigned> clauses;
+    };
+
+    void assign(int literal) {
+        assignments[abs(literal)] = literal;
+        trail.push_back(literal);
     }
-    return no_of_clauses_removed;
-}
 
-//Overload  :   If any assignment causes  clause size to reduce
-//              to one then add that clause to new_unit_clauses.
-unsigned assign_literal(sat_instance_t& sat_instance, int literal,
-                        std::vector<int>& new_unit_clauses) {
+    //Input :   An unsatisfied clause, a no. of open literals, and +1 or -1.
+    //
+    //Output:   Add the clause to, or take it off, the counts of that size.
+    void count_clause(unsigned clause, unsigned size, int delta) {
+        clauses_of_size[size] += delta;
+        if (size > moms_sizes)
+            return;
+        for (auto a : sat_instance[clause])
+            if (!propagated[abs(a)])
+                moms_count[abs(a) * moms_stride + size] += delta;
+    }
+
+    //Input :   An unsatisfied clause, its no. of open literals before and
+    //          after the variable given is assigned or unassigned.
+    //
+    //Output:   Move the clause from the counts of the one size to those of
+    //          the other, the variable counting only where it is open.
+    void move_clause(unsigned clause, unsigned from, unsigned to,
+                     unsigned variable) {
+        clauses_of_size[from]--;
+        clauses_of_size[to]++;
+        if (from > moms_sizes && to > moms_sizes)
+            return;
+        bool shrinking = to < from;
+        for (auto a : sat_instance[clause]) {
+            unsigned v = abs(a);
+            if (propagated[v])
+                continue;
+            unsigned* count = &moms_count[v * moms_stride];
+            if (from <= moms_sizes && (v != variable || shrinking))
+                count[from]--;
+            if (to <= moms_sizes && (v != variable || !shrinking))
+                count[to]++;
+        }
+    }
+
+    //Output:   Update the counters for every literal on the trail past
+    //          propagation_head, assigning the last literal of any clause
+    //          left with one; returns false if a clause has become false.
+    //          A literal's occurrences are all updated even after a
+    //          conflict, so that backtrack() can restore them.
+    bool propagate() {
+        bool consistent = true;
+        while (propagation_head < trail.size()) {
+            int literal = trail[propagation_head++];
+            unsigned variable = abs(literal);
+            for (auto i : occurrences[literal_index(literal)]) {
+                if (true_literals[i]++ == 0) {
+                    no_of_satisfied_clauses++;
+                    count_clause(i, free_literals[i], -1);
+                }
+            }
+            for (auto i : occurrences[literal_index(-literal)]) {
+                if (true_literals[i] != 0) {
+                    free_literals[i]--;
+                    continue;
+                }
+                move_clause(i, free_literals[i], free_literals[i] - 1,
+                            variable);
+                if (--free_literals[i] > 1)
+                    continue;
+                if (free_literals[i] == 0) {
+                    consistent = false;
+                    continue;
+                }
+                //  The one literal not yet false may be assigned already,
+                //  waiting on the trail; then its turn settles the clause.
+                for (auto a : sat_instance[i]) {
+                    if (assignments[abs(a)] == 0) {
+                        assign(a);
+                        break;
+                    }
+                }
+            }
+            propagated[variable] = 1;
+            if (!consistent) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //Input :   A trail size to return to.
+    //
+    //Output:   Undo the assignments past it, restoring the counters of
+    //          those that were propagated.
+    void backtrack(size_t trail_size) {
+        for (size_t i = trail.size(); i-- > trail_size;) {
+            int literal = trail[i];
+            unsigned variable = abs(literal);
+            if (i < propagation_head) {
+                propagated[variable] = 0;
+                for (auto j : occurrences[literal_index(-literal)]) {
+                    if (true_literals[j] == 0)
+                        move_clause(j, free_literals[j], free_literals[j] + 1,
+                                    variable);
+                    free_literals[j]++;
+                }
+                for (auto j : occurrences[literal_index(literal)]) {
+                    if (--true_literals[j] == 0) {
+                        no_of_satisfied_clauses--;
+                        count_clause(j, free_literals[j], 1);
+                    }
+                }
+            }
+            assignments[abs(literal)] = 0;
+        }
+        trail.resize(trail_size);
+        propagation_head = trail_size;
+    }
 
-    unsigned no_of_clauses_removed = 0;
+    //Output:   Find the Most Occuring variable in the Minimum Sized clause,
+    //          counting only the unassigned literals of unsatisfied clauses.
+    //          Called after propagate(), when the open variables are the
+    //          unassigned ones.
+    int pick_literal() {
+        unsigned min_clause_size = 1;
+        while (min_clause_size < clauses_of_size.size()
+                && clauses_of_size[min_clause_size] == 0)
+            min_clause_size++;
+        if (min_clause_size == clauses_of_size.size())
+            return 0;
+
+        unsigned stride = 1;
+        const unsigned* count = variable_count.data();
+        if (min_clause_size <= moms_sizes) {
+            stride = moms_stride;
+            count = &moms_count[min_clause_size];
+        } else {
+            std::fill(variable_count.begin(), variable_count.end(), 0);
+            for (unsigned i = 0; i < no_of_clauses; i++) {
+                if (true_literals[i] != 0 || free_literals[i] != min_clause_size)
+                    continue;
+                for (auto a : sat_instance[i])
+                    if (assignments[abs(a)] == 0)
+                        variable_count[abs(a)]++;
+            }
+        }
 
-    for (auto i = sat_instance.begin(); i < sat_instance.end(); i++) {
-        bool flag = false;
-        for (auto j = i->begin(); j < i->end(); j++) {
-            if (*j == (-literal)) {
-//                i->erase(j);
-                *j = std::move(i->back());
-                i->pop_back();
+        unsigned max_occurrence = 0;
+        unsigned max_occurring_variable = 0;
+        for (unsigned i = 0; i <= no_of_variables; i++) {
+            if (count[i * stride] > max_occurrence) {
+                max_occurrence = count[i * stride];
+                max_occurring_variable = i;
+            }
+        }
+        return static_cast<int>(max_occurring_variable);
+    }
 
-                if (i->size() == 1) {
-                    new_unit_clauses.push_back(i->at(0));
+    //Input :   Variables, and a vector to return components in.
+    //
+    //Output:   Split the open ones among them into the components of the
+    //          unsatisfied clauses they occur in; returns the no. of those
+    //          in no such clause, which may take either value.  Called after
+    //          propagate(), with the variables given covering whole
+    //          components.
+    unsigned decompose(const std::vector<unsigned>& variables,
+                       std::vector<component_t>& components) {
+        if (++stamp == 0) {
+            std::fill(variable_stamp.begin(), variable_stamp.end(), 0);
+            std::fill(clause_stamp.begin(), clause_stamp.end(), 0);
+            stamp = 1;
+        }
+        unsigned no_of_free_variables = 0;
+        component_t component;
+        for (auto v : variables) {
+            if (assignments[v] != 0 || variable_stamp[v] == stamp)
+                continue;
+            variable_stamp[v] = stamp;
+            component.variables.assign(1, v);
+            component.clauses.clear();
+            for (size_t i = 0; i < component.variables.size(); i++) {
+                int variable = static_cast<int>(component.variables[i]);
+                for (int literal : { variable, -variable }) {
+                    for (auto j : occurrences[literal_index(literal)]) {
+                        if (true_literals[j] != 0 || clause_stamp[j] == stamp)
+                            continue;
+                        clause_stamp[j] = stamp;
+                        component.clauses.push_back(j);
+                        for (auto a : sat_instance[j]) {
+                            unsigned u = abs(a);
+                            if (assignments[u] == 0
+                                    && variable_stamp[u] != stamp) {
+                                variable_stamp[u] = stamp;
+                                component.variables.push_back(u);
+                            }
+                        }
+                    }
                 }
-                break;
-            } else if (*j == literal) {
-                flag = true;
-                break;
             }
+            if (component.clauses.empty())
+                no_of_free_variables++;
+            else
+                components.push_back(component);
         }
-        if (flag) {
-            no_of_clauses_removed++;
-//            sat_instance.erase(i);
-            *i = std::move(sat_instance.back());
-            sat_instance.pop_back();
-            i--;
+        return no_of_free_variables;
+    }
+
+    //Output:   Sort the component and return its key in the cache.
+    static component_key_t make_key(component_t& component) {
+        sort(component.variables.begin(), component.variables.end());
+        sort(component.clauses.begin(), component.clauses.end());
+        component_key_t key(component.variables);
+        key.push_back(0);
+        for (auto a : component.clauses)
+            key.push_back(a + 1);
+        return key;
+    }
+
+    //Output:   The variable of the component in the most unsatisfied
+    //          clauses of up to moms_sizes open literals.
+    unsigned pick_variable(const component_t& component) const {
+        unsigned max_occurrence = 0;
+        unsigned max_occurring_variable = component.variables[0];
+        for (auto v : component.variables) {
+            const unsigned* count = &moms_count[v * moms_stride];
+            unsigned occurrence = 0;
+            for (unsigned s = 1; s < moms_stride; s++)
+                occurrence += count[s];
+            if (occurrence > max_occurrence) {
+                max_occurrence = occurrence;
+                max_occurring_variable = v;
+            }
         }
+        return max_occurring_variable;
     }
-    return no_of_clauses_removed;
-}
 
-//Input :   Reference to a sat_instance and reference to a vector<int>.
-//
-//Output:   Modify the  sat_instance  by removing all unit  clauses from
-//          it and add assigned literals to the literals_assigned vector.
-unsigned unit_clause_removal(sat_instance_t& sat_instance,
-                             std::vector<int>& literals_assigned) {
-    std::vector<int> clauses_to_be_removed;
-    unsigned no_of_clauses_removed = 0;
-    for (auto a : sat_instance) {
-        if (a.size() == 1) {
-            literals_assigned.push_back(a[0]);
-            no_of_clauses_removed += assign_literal(sat_instance, a[0],
-                                                    clauses_to_be_removed);
+    //  A component being counted: the variable it branches on, which of
+    //  its two branches has been taken, and the trail size before that;
+    //  the count of the branches done, and of the current one the product
+    //  of the counts of its components so far, the components and the
+    //  next to count.
+    struct count_frame_t {
+        component_t component;
+        component_key_t key;
+        unsigned variable;
+        unsigned phase = 0;
+        size_t trail_size;
+        model_count_t total;
+        model_count_t product;
+        std::vector<component_t> components;
+        size_t next = 0;
+    };
+
+    //Input :   A component not in the cache, with its key, and the cache.
+    //
+    //Output:   Count the models of the component: branch on a variable,
+    //          and in either branch split what is left of the component
+    //          into components and multiply their counts, taken from the
+    //          cache or counted the same way, and by 2 for each variable
+    //          freed.  The components being counted are kept on an explicit
+    //          stack, and their counts go into the cache.
+    model_count_t count_component(component_t& root, component_key_t& key,
+                                  component_cache_t& cache) {
+        std::vector<count_frame_t> frames(1);
+        frames.back().component.variables.swap(root.variables);
+        frames.back().component.clauses.swap(root.clauses);
+        frames.back().key.swap(key);
+        frames.back().variable = pick_variable(frames.back().component);
+        frames.back().trail_size = trail.size();
+        while (true) {
+            count_frame_t& frame = frames.back();
+            if (frame.next < frame.components.size()
+                    && !frame.product.is_zero()) {
+                component_t& component = frame.components[frame.next++];
+                component_key_t key = make_key(component);
+                const model_count_t* count = cache.find(key);
+                if (count) {
+                    frame.product *= *count;
+                    continue;
+                }
+                count_frame_t child;
+                child.component.variables.swap(component.variables);
+                child.component.clauses.swap(component.clauses);
+                child.key.swap(key);
+                child.variable = pick_variable(child.component);
+                child.trail_size = trail.size();
+                frames.push_back(std::move(child));
+                continue;
+            }
+            if (frame.phase > 0) {
+                frame.total += frame.product;
+                backtrack(frame.trail_size);
+            }
+            if (frame.phase == 2) {
+                cache.insert(frame.key, frame.total);
+                model_count_t count = std::move(frame.total);
+                frames.pop_back();
+                if (frames.empty())
+                    return count;
+                frames.back().product *= count;
+                continue;
+            }
+            int variable = static_cast<int>(frame.variable);
+            assign(frame.phase++ == 0 ? variable : -variable);
+            frame.components.clear();
+            frame.next = 0;
+            if (propagate()) {
+                frame.product = model_count_t(1);
+                frame.product <<= decompose(frame.component.variables,
+                                            frame.components);
+            } else {
+                frame.product = model_count_t(0);
+            }
         }
     }
-    while (!clauses_to_be_removed.empty()) {
-        int literal = clauses_to_be_removed.back();
-        clauses_to_be_removed.pop_back();
-        literals_assigned.push_back(literal);
-        no_of_clauses_removed += assign_literal(sat_instance, literal,
-                                                clauses_to_be_removed);
+
+    //Output:   Use the DPLL algorithm below the current assignment: returns
+    //          true with the trail holding a model, or false with the trail
+    //          as it was if there is none.  The decisions are kept on an
+    //          explicit stack, so the depth of the search tree costs no
+    //          call stack: a conflict undoes the trail back to the
+    //          innermost decision not yet flipped, and takes its other
+    //          branch.
+    bool search() {
+        size_t trail_size = trail.size();
+        decisions.clear();
+        while (true) {
+            if (stop && stop->load(std::memory_order_relaxed)) {
+                backtrack(trail_size);
+                return false;
+            }
+            if (propagate()) {
+                if (no_of_satisfied_clauses == no_of_clauses)
+                    return true;
+                int literal = pick_literal();
+                if (literal) {
+                    decisions.push_back({ trail.size(), literal, false });
+                    assign(literal);
+                    continue;
+                }
+            }
+            while (!decisions.empty() && decisions.back().flipped)
+                decisions.pop_back();
+            if (decisions.empty()) {
+                backtrack(trail_size);
+                return false;
+            }
+            decision_t& decision = decisions.back();
+            backtrack(decision.trail_size);
+            decision.flipped = true;
+            assign(-decision.literal);
+        }
     }
-    return no_of_clauses_removed;
-}
 
-//Overload  :   Does not place assigned literals on the output vector.
-unsigned unit_clause_removal(sat_instance_t& sat_instance) {
-    std::vector<int> clauses_to_be_removed;
-    unsigned no_of_clauses_removed = 0;
-    for (auto a : sat_instance) {
-        if (a.size() == 1) {
-            no_of_clauses_removed += assign_literal(sat_instance, a[0],
-                                                    clauses_to_be_removed);
+ public:
+    explicit dpll_solver_t(const sat_instance_t& sat_instance)
+            : sat_instance(sat_instance),
+              occurrences((no_of_variables + 1) << 1),
+              true_literals(no_of_clauses),
+              free_literals(no_of_clauses),
+              assignments(no_of_variables + 1),
+              propagated(no_of_variables + 1),
+              variable_count(no_of_variables + 1),
+              variable_stamp(no_of_variables + 1),
+              clause_stamp(no_of_clauses) {
+        size_t max_clause_size = 0;
+        for (auto& a : sat_instance)
+            max_clause_size = std::max(max_clause_size, a.size());
+        clauses_of_size.resize(max_clause_size + 1);
+        moms_stride = static_cast<unsigned>(
+                std::min<size_t>(max_clause_size, moms_sizes) + 1);
+        moms_count.resize(static_cast<size_t>(moms_stride)
+                * (no_of_variables + 1));
+        for (unsigned i = 0; i < no_of_clauses; i++) {
+            free_literals[i] = static_cast<unsigned>(sat_instance[i].size());
+            for (auto a : sat_instance[i])
+                occurrences[literal_index(a)].push_back(i);
+            count_clause(i, free_literals[i], 1);
+            if (sat_instance[i].size() == 1)
+                units.push_back(sat_instance[i][0]);
         }
+        empty_clause = has_empty_clause(sat_instance);
+        trail.reserve(no_of_variables);
+        reset();
     }
-    while (!clauses_to_be_removed.empty()) {
-        int literal = clauses_to_be_removed.back();
-        clauses_to_be_removed.pop_back();
-        no_of_clauses_removed += assign_literal(sat_instance, literal,
-                                                clauses_to_be_removed);
+
+    //Output:   Drop every assumption, leaving only the unit clauses of the
+    //          formula assigned and propagated.
+    void reset() {
+        backtrack(0);
+        inconsistent = empty_clause;
+        for (auto a : units) {
+            if (inconsistent || assignments[abs(a)] == -a) {
+                inconsistent = true;
+                return;
+            }
+            if (assignments[abs(a)] == 0)
+                assign(a);
+        }
+        inconsistent = !propagate() || empty_clause;
     }
-    return no_of_clauses_removed;
-}
 
-//Input :   A sat_instance and a reference to a vector<int>.
-//
-//Output:   Use  the  DPLL  algorithm  to   find  a  satisfiable
-//          assignment and return TRUE along with the assignment
-//          placed on the input vector<int>. Else  return  FALSE
-//          if a satisfying does not exist.
-//
-//Note  :   sat_instance provided as input  may  get  modified
-//          but is not an output and is taken as reference  to
-//          avoid   copying   and  improve   performance  only.
-bool dpll(sat_instance_t& sat_instance,
-          std::vector<int>& satisfying_assignment) {
-    std::vector<int> literals_assigned_by_unit_propagation;
-    unit_clause_removal(sat_instance, literals_assigned_by_unit_propagation);
-
-    if (sat_instance.empty()) {
-        satisfying_assignment.insert(
-                satisfying_assignment.end(),
-                literals_assigned_by_unit_propagation.begin(),
-                literals_assigned_by_unit_propagation.end());
-        return true;
+    //Input :   A literal.
+    //
+    //Output:   Assume it, along with what unit propagation implies, until
+    //          the next reset(); returns false if that contradicts the
+    //          formula under the earlier assumptions.
+    bool assume(int literal) {
+        if (inconsistent || assignments[abs(literal)] == -literal)
+            return !(inconsistent = true);
+        if (assignments[abs(literal)] == 0)
+            assign(literal);
+        inconsistent = !propagate();
+        return !inconsistent;
     }
 
-    if (has_empty_clause(sat_instance)) {
-        return false;
+    //  True if the assumptions satisfy every clause.
+    bool satisfied() const {
+        return no_of_satisfied_clauses == no_of_clauses;
     }
 
-    int literal = pick_literal(sat_instance);
-    if (!literal)
-        return false;
+    //  The literal search() would branch on first, 0 if the assumptions
+    //  satisfy the formula.
+    int branch_literal() {
+        return pick_literal();
+    }
 
-    sat_instance_t branch_assignment = sat_instance;
-    assign_literal(branch_assignment, literal);
-    if (dpll(branch_assignment, satisfying_assignment)) {
-        satisfying_assignment.push_back(literal);
-        satisfying_assignment.insert(
-                satisfying_assignment.end(),
-                literals_assigned_by_unit_propagation.begin(),
-                literals_assigned_by_unit_propagation.end());
-        return true;
+    //Output:   Returns true if the formula has a model in which the
+    //          assumptions hold, which model() then holds; false if there
+    //          is none or the stop flag was set first.
+    bool solve() {
+        return !inconsistent && search();
     }
 
-    branch_assignment = sat_instance;
-    assign_literal(branch_assignment, -literal);
-    if (dpll(branch_assignment, satisfying_assignment)) {
-        satisfying_assignment.push_back(-literal);
-        satisfying_assignment.insert(
-                satisfying_assignment.end(),
-                literals_assigned_by_unit_propagation.begin(),
-                literals_assigned_by_unit_propagation.end());
-        return true;
+    //  Give up the search once the flag is set.
+    void set_stop(const std::atomic<bool>* stop) {
+        this->stop = stop;
     }
 
-    return false;
+    //Input :   The most memory the component cache may take.
+    //
+    //Output:   Returns the no. of models of the formula, over all its
+    //          variables, as the product of the counts of its components.
+    //          Drops every assumption.
+    model_count_t count_models(size_t cache_bytes) {
+        reset();
+        model_count_t count;
+        if (!inconsistent) {
+            std::vector<unsigned> variables(no_of_variables);
+            std::iota(variables.begin(), variables.end(), 1);
+            std::vector<component_t> components;
+            count = model_count_t(1);
+            count <<= decompose(variables, components);
+            component_cache_t cache(cache_bytes);
+            for (auto& a : components) {
+                component_key_t key = make_key(a);
+                count *= count_component(a, key, cache);
+                if (count.is_zero())
+                    break;
+            }
+        }
+        reset();
+        return count;
+    }
+
+    //  The satisfying assignment, one literal per variable set; variables
+    //  left out may take either value.
+    const std::vector<int>& model() const {
+        return trail;
+    }
+};
+
+//Input :   A sat_instance, no. of workers and a reference to return a
+//          model in.
+//
+//Output:   Parallel DPLL: each worker takes a cube off a work-stealing
+//          pool, starting from the empty one, and assumes its literals.
+//          While the cube is shorter than cutoff_depth, the worker pushes
+//          the cube extended by the negation of the branching literal
+//          back, and goes on with the literal itself; deeper down it
+//          searches the rest alone.  The first model found stops every
+//          worker and is copied into model; returns false if no cube has
+//          one.
+bool solve_parallel(const sat_instance_t& sat_instance, unsigned no_of_workers,
+                    std::vector<int>& model) {
+    cube_pool_t pool(no_of_workers);
+    pool.push(0, std::vector<int>());
+    std::atomic<bool> stop { false };
+    std::atomic<int> winner { -1 };
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < no_of_workers; i++) {
+        threads.emplace_back([&, i]() {
+            dpll_solver_t solver(sat_instance);
+            solver.set_stop(&stop);
+            std::vector<int> cube;
+            while (pool.take(i, cube, stop)) {
+                solver.reset();
+                bool consistent = true;
+                for (size_t j = 0; j < cube.size() && consistent; j++)
+                    consistent = solver.assume(cube[j]);
+                while (consistent && !solver.satisfied()
+                        && cube.size() < cutoff_depth) {
+                    int literal = solver.branch_literal();
+                    cube.push_back(-literal);
+                    pool.push(i, cube);
+                    cube.back() = literal;
+                    consistent = solver.assume(literal);
+                }
+                if (consistent && solver.solve()) {
+                    int none = -1;
+                    if (winner.compare_exchange_strong(none, (int) i))
+                        model = solver.model();
+                    stop.store(true);
+                }
+                pool.finish();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    return winner.load() >= 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     auto start_time = std::chrono::high_resolution_clock::now();
 
+    const char* path = nullptr;
+    unsigned no_of_threads = 1;
+    bool count = false;
+    bool usage_error = false;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option[0] != '-' && !path) {
+            path = argv[i];
+        } else if (option.compare(0, 10, "--threads=") == 0) {
+            no_of_threads = std::max(1, atoi(option.c_str() + 10));
+        } else if (option.compare(0, 9, "--cutoff=") == 0) {
+            cutoff_depth = std::max(0, atoi(option.c_str() + 9));
+        } else if (option == "--count") {
+            count = true;
+        } else if (option.compare(0, 11, "--cache-mb=") == 0) {
+            cache_bytes = static_cast<size_t>(
+                    std::max(0, atoi(option.c_str() + 11))) << 20;
+        } else {
+            usage_error = true;
+        }
+    }
+    if (usage_error || (count && no_of_threads > 1)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--threads=N] [--cutoff=DEPTH] [instance.cnf]\n"
+                  << "       " << argv[0]
+                  << " --count [--cache-mb=M] [instance.cnf]\n";
+        return 1;
+    }
+
     sat_instance_t sat_instance;
-    initialize_sat_instance(sat_instance);
+    if (!initialize_sat_instance(sat_instance, path)) {
+        std::cerr << "Could not read a DIMACS instance\n";
+        return 1;
+    }
 
     std::vector<int> result;
-    if (dpll(sat_instance, result)) {
-        std::cout << "SAT\n";
-        sort(result.begin(), result.end(), absolute_comparator);
-
-        unsigned track_unused_variables = 1;
-        int track_duplicate_print = 0;
-
-        for (auto a : result) {
-            while (static_cast<unsigned>(abs(a)) > track_unused_variables
-                    && track_unused_variables <= no_of_variables) {
-//                std::cout << track_unused_variables << ' ';
-                track_unused_variables++;
-            }
-            if (static_cast<unsigned>(abs(a)) <= no_of_variables
-                    && a != track_duplicate_print) {
+    bool satisfiable;
+    if (count) {
+        dpll_solver_t solver(sat_instance);
+        std::cout << solver.count_models(cache_bytes).to_string();
+    } else {
+        if (no_of_threads > 1) {
+            satisfiable = solve_parallel(sat_instance, no_of_threads, result);
+        } else {
+            dpll_solver_t solver(sat_instance);
+            satisfiable = solver.solve();
+            if (satisfiable)
+                result = solver.model();
+        }
+        if (satisfiable) {
+            std::cout << "SAT\n";
+            sort(result.begin(), result.end(), absolute_comparator);
+            for (auto a : result)
                 std::cout << a << ' ';
-                track_duplicate_print = a;
-            }
-            track_unused_variables++;
+            std::cout << 0;
+        } else {
+            std::cout << "UNSAT";
         }
-
-        std::cout << 0;
-    } else {
-        std::cout << "UNSAT";
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
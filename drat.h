@@ -0,0 +1,115 @@
+//============================================================================
+// Name        : drat.h
+// Author      : Akash Banerjee (CS18MTECH11023)
+// Description : Binary DRAT proof writer, Ansi-style
+//               Logs the clauses a solver adds and deletes so that an
+//               UNSAT answer can be checked, e.g. with drat-trim.  Each
+//               clause is 'a' or 'd' followed by its literals, 2v for v
+//               and 2v + 1 for -v, as little endian base 128 varints, and
+//               a 0 byte; it goes into a large buffer which is written out
+//               with write(2) only when full, so logging costs a few bytes
+//               of copying per literal.
+//============================================================================
+
+#ifndef DRAT_H_
+#define DRAT_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <vector>
+
+class drat_writer_t {
+    int fd;
+    std::vector<unsigned char> buffer;
+    size_t used = 0;
+    bool failed = false;
+
+    //Input :   'a' or 'd' and the literals of a clause.
+    //
+    //Output:   Append the clause to the buffer, flushing it first if the
+    //          clause might not fit.
+    void write_clause(unsigned char kind, const int* begin, const int* end) {
+        size_t needed = 2 + 5 * static_cast<size_t>(end - begin);
+        if (buffer.size() - used < needed) {
+            flush();
+            if (buffer.size() < needed)
+                buffer.resize(needed);
+        }
+        unsigned char* out = buffer.data() + used;
+        *out++ = kind;
+        for (const int* a = begin; a != end; a++) {
+            unsigned value = 2u * static_cast<unsigned>(abs(*a)) + (*a < 0);
+            while (value > 127) {
+                *out++ = static_cast<unsigned char>(value | 128);
+                value >>= 7;
+            }
+            *out++ = static_cast<unsigned char>(value);
+        }
+        *out++ = 0;
+        used = out - buffer.data();
+    }
+
+ public:
+    //Input :   Path of the proof file, created or truncated, and the size of
+    //          the write buffer.
+    explicit drat_writer_t(const char* path, size_t buffer_size = 1 << 20)
+            : fd { open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) },
+              buffer(buffer_size) {
+        failed = fd < 0;
+    }
+
+    drat_writer_t(const drat_writer_t&) = delete;
+    drat_writer_t& operator=(const drat_writer_t&) = delete;
+
+    ~drat_writer_t() {
+        close_proof();
+    }
+
+    void add(const int* begin, const int* end) {
+        write_clause('a', begin, end);
+    }
+
+    void remove(const int* begin, const int* end) {
+        write_clause('d', begin, end);
+    }
+
+    //  Log the empty clause, the end of a refutation.
+    void add_empty() {
+        write_clause('a', nullptr, nullptr);
+    }
+
+    //Output:   Write out the buffer; returns false if this or an earlier
+    //          write failed.
+    bool flush() {
+        size_t written = 0;
+        while (!failed && written < used) {
+            ssize_t n = write(fd, buffer.data() + written, used - written);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                failed = true;
+            else
+                written += n;
+        }
+        used = 0;
+        return !failed;
+    }
+
+    //Output:   Flush and close the file; returns false if any write failed.
+    bool close_proof() {
+        flush();
+        if (fd >= 0 && close(fd) != 0)
+            failed = true;
+        fd = -1;
+        return !failed;
+    }
+
+    bool good() const {
+        return !failed;
+    }
+};
+
+#endif //DRAT_H_
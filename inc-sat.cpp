@@ -16,6 +16,8 @@
 #include <cmath>
 #include <bits/stdc++.h>
 
+#include "dimacs.h"
+
 // Compile with '-DDEBUG' flag to enable debug print statements.
 #ifdef DEBUG
 #include <chrono>
@@ -39,7 +41,7 @@ void print_sat_instance(const sat_instance_t &);
 
 inline bool compare_scores(std::pair<double, long>, std::pair<double, long>);
 inline long abs(long);
-void initialize_sat_instance(sat_instance_t&);
+bool initialize_sat_instance(sat_instance_t&, const char* path);
 void assign_literal(sat_instance_t&, long literal);
 void assign_literal(sat_instance_t&, long literal,
                     std::vector<long>& new_unit_clauses);
@@ -79,38 +81,24 @@ inline long abs(long a) {
     return a;
 }
 
-//Input :   Reference to a sat_instance.
+//Input :   Reference to a sat_instance, and the path of the DIMACS
+//          input, nullptr for stdin.
 //
-//Output:   Initialize the  provided   sat_instance
-void initialize_sat_instance(sat_instance_t &sat_instance) {
-    char a;
-    std::cin >> a;
-    while (a != 'p') {
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::cin >> a;
-    }
-    std::cin.ignore(5);
-    std::cin >> no_of_variables;
-    std::cin >> no_of_clauses;
+//Output:   Initialize the  provided   sat_instance, returns false
+//          if the input could not be read.
+bool initialize_sat_instance(sat_instance_t &sat_instance, const char* path) {
+    dimacs_instance_t instance;
+    if (!read_dimacs(path, instance)) return false;
+    no_of_variables = instance.no_of_variables;
+    no_of_clauses = instance.no_of_clauses;
 
     sat_instance.reserve(no_of_clauses);
     for (long i = 0; i < no_of_clauses; i++) {
-        long literal;
-        clause_t clause;
-        std::cin.ignore(10, '\n');
-        while (true) {
-            std::cin >> literal;
-            if (!std::cin.good()) {
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
-                                '\n');
-                continue;
-            }
-            if (literal == 0) break;
-            clause.push_back(literal);
-        }
-        sat_instance.push_back(std::make_pair(clause, i));
+        sat_instance.push_back(
+                std::make_pair(clause_t(instance.begin(i), instance.end(i)),
+                               i));
     }
+    return true;
 }
 
 //Input :   Sat instance and a literal.
@@ -402,14 +390,17 @@ model_t solve(sat_instance_t &sat_instance, long max_flips = no_of_clauses) {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
 
 #ifdef DEBUG
     auto start_time = std::chrono::high_resolution_clock::now();
 #endif //DEBUG
 
     sat_instance_t sat_instance;
-    initialize_sat_instance(sat_instance);
+    if (!initialize_sat_instance(sat_instance, argc > 1 ? argv[1] : nullptr)) {
+        std::cerr << "Could not read a DIMACS instance\n";
+        return 1;
+    }
 
     auto model = solve(sat_instance);
 
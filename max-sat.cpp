@@ -13,7 +13,8 @@
 #include <chrono>
 #endif //DEBUG
 
-#include <core/Solver.h>
+#include "cdcl.h"
+#include "dimacs.h"
 
 typedef std::vector<int> clause_t;
 typedef std::vector<clause_t> sat_instance_t;
@@ -33,8 +34,8 @@ static unsigned total_no_of_clauses;
 void print_sat_instance(const sat_instance_t &);
 #endif //DEBUG
 
-void initialize_sat_instance(sat_instance_t&);
-void initialize_minisat_instance(sat_instance_t &, Minisat::Solver &);
+bool initialize_sat_instance(sat_instance_t&, const char* path);
+void initialize_solver(sat_instance_t &, cdcl_solver_t &);
 unsigned apply_totalizer_encoding(sat_instance_t &, unsigned, unsigned);
 
 #ifdef DEBUG
@@ -48,61 +49,39 @@ void print_sat_instance(const sat_instance_t &sat_instance) {
 }
 #endif //DEBUG
 
-//Input :   Reference to a sat_instance.
+//Input :   Reference to a sat_instance, and the path of the DIMACS
+//          input, nullptr for stdin.
 //
-//Output:   Initialize the  provided   sat_instance
-void initialize_sat_instance(sat_instance_t &sat_instance) {
-    char a;
-    std::cin >> a;
-    while (a != 'p') {
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::cin >> a;
-    }
-    std::cin.ignore(5);
-    std::cin >> no_of_variables;
-    std::cin >> no_of_clauses;
+//Output:   Initialize the  provided   sat_instance, returns false
+//          if the input could not be read.
+bool initialize_sat_instance(sat_instance_t &sat_instance, const char* path) {
+    dimacs_instance_t instance;
+    if (!read_dimacs(path, instance)) return false;
+    no_of_variables = instance.no_of_variables;
+    no_of_clauses = instance.no_of_clauses;
 
     totalizer_variables_counter = no_of_variables;
     total_no_of_variables = no_of_variables;
     total_no_of_clauses = no_of_clauses;
 
     sat_instance.reserve(no_of_clauses);
-    for (unsigned i = 0; i < no_of_clauses; i++) {
-        int literal;
-        clause_t clause;
-        std::cin.ignore(10, '\n');
-        while (true) {
-            std::cin >> literal;
-            if (!std::cin.good()) {
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
-                                '\n');
-                continue;
-            }
-            if (literal == 0) break;
-            clause.push_back(literal);
-        }
-        sat_instance.push_back(clause);
-    }
+    for (unsigned i = 0; i < no_of_clauses; i++)
+        sat_instance.emplace_back(instance.begin(i), instance.end(i));
+    return true;
 }
 
 //Input :   Reference to a sat_instance and a
-//          minisat solver instance.
+//          cdcl solver instance.
 //
-//Output:   Initialize the  minisat solver instance
+//Output:   Initialize the  cdcl solver instance
 //          using the sat_instance.
-inline void initialize_minisat_instance(sat_instance_t &sat_instance,
-                                        Minisat::Solver &ms_solver) {
-    ms_solver.newVar();
+inline void initialize_solver(sat_instance_t &sat_instance,
+                              cdcl_solver_t &solver) {
     for (unsigned i = 1; i <= total_no_of_variables; i++) {
-        ms_solver.newVar();
+        solver.new_variable();
     }
-    for (clause_t clause : sat_instance) {
-        Minisat::vec < Minisat::Lit > temp_clause;
-        for (int lit : clause) {
-            temp_clause.push(Minisat::mkLit(abs(lit), ((lit) < 0)));
-        }
-        ms_solver.addClause(temp_clause);
+    for (const clause_t &clause : sat_instance) {
+        solver.add_clause(clause);
     }
 }
 
@@ -157,14 +136,18 @@ unsigned apply_totalizer_encoding(
 
 }
 
-int main() {
+int main(int argc, char* argv[]) {
 
 #ifdef DEBUG
     auto start_time = std::chrono::high_resolution_clock::now();
 #endif //DEBUG
 
     sat_instance_t sat_instance;
-    initialize_sat_instance(sat_instance);          //Parse the input
+    if (!initialize_sat_instance(sat_instance,      //Parse the input
+                                 argc > 1 ? argv[1] : nullptr)) {
+        std::cerr << "Could not read a DIMACS instance\n";
+        return 1;
+    }
 
     totalizer_output_variables_begin = apply_totalizer_encoding(sat_instance)
             + 1;                                   //Apply totalizer encoding on the input.
@@ -176,29 +159,29 @@ int main() {
     << std::endl;
 #endif //DEBUG
 
-    Minisat::Solver ms_solver;
-    initialize_minisat_instance(sat_instance, ms_solver);   //Initialize the minisat solver instance.
+    cdcl_solver_t solver;
+    initialize_solver(sat_instance, solver);                //Initialize the cdcl solver instance.
     sat_instance.clear();
 
-    Minisat::vec < Minisat::Lit > assumps;                  //Start by assuming all the totalizer output variables are negated
+    std::vector<int> assumptions;                           //Start by assuming all the totalizer output variables are negated
     unsigned no_of_relaxed_clauses = 0;
     for (unsigned i = total_no_of_variables;
             i >= totalizer_output_variables_begin; i--) {
-        assumps.push(Minisat::mkLit(i, true));
+        assumptions.push_back(-(int) i);
     }
-    while (!ms_solver.solve(assumps)) {                     //Every iteration remove one of the assumptions in ascending order
-        assumps.pop();                                      //until the the formula is satisfiable.
-        no_of_relaxed_clauses++;
+    while (solver.solve(assumptions) != result_sat) {       //Every iteration remove assumptions in ascending order
+        int relaxed;                                        //until the the formula is satisfiable; it stays
+        do {                                                //unsatisfiable while all of the final conflict is assumed.
+            relaxed = assumptions.back();
+            assumptions.pop_back();
+            no_of_relaxed_clauses++;
+        } while (!solver.failed(relaxed) && !assumptions.empty());
     }
 
     std::cout << no_of_clauses - no_of_relaxed_clauses << std::endl;    //Print output.
-    Minisat::lbool l_t((uint8_t) 0);
+    const std::vector<int> &model = solver.model();
     for (unsigned i = 1; i <= no_of_variables; i++) {
-        if (ms_solver.model[i] == l_t) {
-            std::cout << i << ' ';
-        }
-        else
-            std::cout << -(int) i << ' ';
+        std::cout << model[i] << ' ';
     }
     std::cout << 0;
 
@@ -0,0 +1,416 @@
+//============================================================================
+// Name        : preprocess.h
+// Author      : Akash Banerjee (CS18MTECH11023)
+// Description : SatELite style CNF preprocessing, Ansi-style
+//               Top level unit propagation, backward subsumption,
+//               self-subsuming resolution and bounded variable elimination
+//               over occurrence lists. Clauses removed by elimination are
+//               kept on a stack that extends a model of the simplified
+//               formula to the eliminated variables.
+//============================================================================
+
+#ifndef PREPROCESS_H_
+#define PREPROCESS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+class preprocessor_t {
+    struct clause_t {
+        std::vector<int> literals;
+        uint64_t signature;     //  One bit per variable, modulo 64.
+        bool deleted;
+    };
+
+    unsigned no_of_variables;
+    std::vector<clause_t> clauses;
+    std::vector<std::vector<unsigned>> occurs;
+    std::vector<int> value;
+    std::vector<char> eliminated;
+    std::vector<char> touched;
+    std::vector<char> marks;
+    std::vector<int> units;
+    std::vector<unsigned> subsumption_queue;
+    std::vector<char> queued;
+    long budget = 0;
+    bool unsat = false;
+    unsigned no_of_eliminated = 0;
+
+    //  Clauses of each eliminated variable with its literal first, each
+    //  followed by its size; replayed backwards by extend_model.
+    std::vector<int> elimination_stack;
+
+    static unsigned index(int literal) {
+        return (static_cast<unsigned>(abs(literal)) << 1) | (literal < 0);
+    }
+
+    static uint64_t signature(const std::vector<int>& literals) {
+        uint64_t bits = 0;
+        for (int literal : literals)
+            bits |= 1ULL << (abs(literal) & 63);
+        return bits;
+    }
+
+    int literal_value(int literal) const {
+        int v = value[abs(literal)];
+        return literal > 0 ? v : -v;
+    }
+
+    void enqueue(unsigned c) {
+        if (!queued[c]) {
+            queued[c] = 1;
+            subsumption_queue.push_back(c);
+        }
+    }
+
+    void remove_occurrence(int literal, unsigned c) {
+        std::vector<unsigned>& list = occurs[index(literal)];
+        budget -= static_cast<long>(list.size());
+        auto i = std::find(list.begin(), list.end(), c);
+        *i = list.back();
+        list.pop_back();
+    }
+
+    void attach(std::vector<int> literals) {
+        if (literals.empty()) {
+            unsat = true;
+            return;
+        }
+        if (literals.size() == 1) {
+            units.push_back(literals[0]);
+            return;
+        }
+        unsigned c = static_cast<unsigned>(clauses.size());
+        for (int literal : literals)
+            occurs[index(literal)].push_back(c);
+        uint64_t bits = signature(literals);
+        clauses.push_back( { std::move(literals), bits, false });
+        queued.push_back(0);
+        enqueue(c);
+    }
+
+    void delete_clause(unsigned c) {
+        clause_t& clause = clauses[c];
+        clause.deleted = true;
+        for (int literal : clause.literals) {
+            remove_occurrence(literal, c);
+            touched[abs(literal)] = 1;
+        }
+        std::vector<int>().swap(clause.literals);
+    }
+
+    //  Remove literal from clause c, which stays implied by the formula.
+    void strengthen(unsigned c, int literal) {
+        clause_t& clause = clauses[c];
+        remove_occurrence(literal, c);
+        touched[abs(literal)] = 1;
+        std::vector<int>& literals = clause.literals;
+        literals.erase(std::find(literals.begin(), literals.end(), literal));
+        clause.signature = signature(literals);
+        if (literals.size() == 1) {
+            units.push_back(literals[0]);
+            delete_clause(c);
+        } else {
+            enqueue(c);
+        }
+    }
+
+    //Output:   Assign the pending units, dropping the clauses they satisfy
+    //          and strengthening those they falsify a literal of; false if
+    //          that derives the empty clause.
+    bool propagate() {
+        while (!units.empty() && !unsat) {
+            int literal = units.back();
+            units.pop_back();
+            if (literal_value(literal) == 1)
+                continue;
+            if (literal_value(literal) == -1) {
+                unsat = true;
+                break;
+            }
+            value[abs(literal)] = literal > 0 ? 1 : -1;
+            std::vector<unsigned>& satisfied = occurs[index(literal)];
+            while (!satisfied.empty())
+                delete_clause(satisfied.back());
+            std::vector<unsigned> falsified = occurs[index(-literal)];
+            for (unsigned c : falsified)
+                strengthen(c, -literal);
+        }
+        return !unsat;
+    }
+
+    //Input :   A clause index.
+    //
+    //Output:   Delete every clause the clause subsumes and strengthen every
+    //          clause it resolves with into a subset of that clause. Only
+    //          the occurrences of its least frequent variable are visited,
+    //          as each such clause must contain that variable.
+    void backward_subsume(unsigned c) {
+        const std::vector<int>& literals = clauses[c].literals;
+        uint64_t bits = clauses[c].signature;
+        int best = literals[0];
+        size_t best_count = SIZE_MAX;
+        for (int literal : literals) {
+            size_t count = occurs[index(literal)].size()
+                    + occurs[index(-literal)].size();
+            if (count < best_count) {
+                best = literal;
+                best_count = count;
+            }
+            marks[index(literal)] = 1;
+        }
+        for (int side : { best, -best }) {
+            std::vector<unsigned> candidates = occurs[index(side)];
+            for (unsigned d : candidates) {
+                clause_t& other = clauses[d];
+                if (d == c || other.deleted
+                        || other.literals.size() < literals.size()
+                        || (bits & ~other.signature) != 0)
+                    continue;
+                budget -= static_cast<long>(other.literals.size());
+                size_t common = 0;
+                int flipped = 0;
+                bool mismatch = false;
+                for (int literal : other.literals) {
+                    if (marks[index(literal)]) {
+                        common++;
+                    } else if (marks[index(-literal)]) {
+                        if (flipped) {
+                            mismatch = true;
+                            break;
+                        }
+                        flipped = literal;
+                    }
+                }
+                if (mismatch || common + (flipped != 0) != literals.size())
+                    continue;
+                if (flipped)
+                    strengthen(d, flipped);
+                else
+                    delete_clause(d);
+            }
+        }
+        for (int literal : literals)
+            marks[index(literal)] = 0;
+    }
+
+    //Output:   Run backward subsumption for every queued clause; false if
+    //          the formula turned out to be unsatisfiable.
+    bool subsume_queued() {
+        while (!subsumption_queue.empty()) {
+            if (!propagate())
+                return false;
+            unsigned c = subsumption_queue.back();
+            subsumption_queue.pop_back();
+            queued[c] = 0;
+            if (budget > 0 && !clauses[c].deleted)
+                backward_subsume(c);
+        }
+        return propagate();
+    }
+
+    //Input :   Two clause indices and the variable they clash on.
+    //
+    //Output:   Their resolvent in resolvent; false if it is a tautology.
+    bool resolve(unsigned p, unsigned n, unsigned variable,
+                 std::vector<int>& resolvent) {
+        resolvent.clear();
+        const std::vector<int>& positive = clauses[p].literals;
+        const std::vector<int>& negative = clauses[n].literals;
+        budget -= static_cast<long>(positive.size() + negative.size());
+        for (int literal : positive)
+            if (static_cast<unsigned>(abs(literal)) != variable) {
+                resolvent.push_back(literal);
+                marks[index(literal)] = 1;
+            }
+        bool tautology = false;
+        for (int literal : negative) {
+            if (static_cast<unsigned>(abs(literal)) == variable)
+                continue;
+            if (marks[index(-literal)]) {
+                tautology = true;
+                break;
+            }
+            if (!marks[index(literal)])
+                resolvent.push_back(literal);
+        }
+        for (int literal : positive)
+            marks[index(literal)] = 0;
+        return !tautology;
+    }
+
+    void push_elimination_clause(unsigned variable, int literal,
+                                 const std::vector<int>& literals) {
+        elimination_stack.push_back(literal);
+        for (int other : literals)
+            if (static_cast<unsigned>(abs(other)) != variable)
+                elimination_stack.push_back(other);
+        elimination_stack.push_back(static_cast<int>(literals.size()));
+    }
+
+    //Input :   A variable.
+    //
+    //Output:   Replace its clauses by all their non-tautological resolvents
+    //          on it, provided the limits allow; true if it was eliminated.
+    bool try_eliminate(unsigned variable) {
+        if (value[variable] || eliminated[variable])
+            return false;
+        int literal = static_cast<int>(variable);
+        std::vector<unsigned> positive = occurs[index(literal)];
+        std::vector<unsigned> negative = occurs[index(-literal)];
+        if (positive.empty() && negative.empty())
+            return false;
+        if (positive.size() > occurrence_limit
+                && negative.size() > occurrence_limit)
+            return false;
+
+        size_t limit = positive.size() + negative.size() + clause_growth;
+        std::vector<std::vector<int>> resolvents;
+        std::vector<int> resolvent;
+        for (unsigned p : positive)
+            for (unsigned n : negative) {
+                if (!resolve(p, n, variable, resolvent))
+                    continue;
+                if (resolvents.size() == limit
+                        || resolvent.size() > resolvent_limit || budget <= 0)
+                    return false;
+                resolvents.push_back(resolvent);
+            }
+
+        //  Keep the smaller side, and after it a unit of the other polarity
+        //  as the default value, which the kept clauses override if needed.
+        bool keep_positive = positive.size() <= negative.size();
+        for (unsigned c : keep_positive ? positive : negative)
+            push_elimination_clause(variable, keep_positive ? literal : -literal,
+                                    clauses[c].literals);
+        elimination_stack.push_back(keep_positive ? -literal : literal);
+        elimination_stack.push_back(1);
+
+        eliminated[variable] = 1;
+        no_of_eliminated++;
+        for (unsigned c : positive)
+            delete_clause(c);
+        for (unsigned c : negative)
+            delete_clause(c);
+        for (auto& r : resolvents)
+            attach(std::move(r));
+        return true;
+    }
+
+ public:
+    //  Limits of variable elimination: a variable is only eliminated if
+    //  that adds at most clause_growth clauses, no resolvent is longer than
+    //  resolvent_limit, and one polarity occurs at most occurrence_limit
+    //  times. effort_limit bounds the literals visited overall.
+    unsigned resolvent_limit = 20;
+    unsigned clause_growth = 0;
+    unsigned occurrence_limit = 100;
+    long effort_limit = 200000000;
+
+    explicit preprocessor_t(unsigned no_of_variables)
+            : no_of_variables { no_of_variables },
+              occurs((no_of_variables << 1) + 2),
+              value(no_of_variables + 1),
+              eliminated(no_of_variables + 1),
+              touched(no_of_variables + 1, 1),
+              marks((no_of_variables << 1) + 2) {
+    }
+
+    //Input :   A clause over distinct variables.
+    void add_clause(const std::vector<int>& literals) {
+        attach(literals);
+    }
+
+    //Output:   Simplify the clauses added so far; false if they are
+    //          unsatisfiable.
+    bool simplify() {
+        budget = effort_limit;
+        if (!subsume_queued())
+            return false;
+        std::vector<unsigned> candidates;
+        while (budget > 0) {
+            candidates.clear();
+            for (unsigned v = 1; v <= no_of_variables; v++) {
+                if (touched[v] && !value[v] && !eliminated[v])
+                    candidates.push_back(v);
+                touched[v] = 0;
+            }
+            if (candidates.empty())
+                break;
+            //  Cheapest first: fewest resolvents to try.
+            std::sort(candidates.begin(), candidates.end(),
+                      [this](unsigned a, unsigned b) {
+                          return occurs[index(a)].size() * occurs[index(-(int) a)].size()
+                                  < occurs[index(b)].size() * occurs[index(-(int) b)].size();
+                      });
+            for (unsigned v : candidates) {
+                if (budget <= 0)
+                    break;
+                try_eliminate(v);
+                if (!subsume_queued())
+                    return false;
+            }
+        }
+        return !unsat;
+    }
+
+    bool is_eliminated(unsigned variable) const {
+        return eliminated[variable];
+    }
+
+    unsigned eliminated_count() const {
+        return no_of_eliminated;
+    }
+
+    //Input :   A function taking a std::vector<int>.
+    //
+    //Output:   Call it with every clause of the simplified formula, the
+    //          fixed variables as unit clauses first.
+    template<typename function_t>
+    void for_each_clause(function_t function) const {
+        std::vector<int> unit(1);
+        for (unsigned v = 1; v <= no_of_variables; v++)
+            if (value[v]) {
+                unit[0] = value[v] * static_cast<int>(v);
+                function(unit);
+            }
+        for (const clause_t& clause : clauses)
+            if (!clause.deleted)
+                function(clause.literals);
+    }
+
+    //  Free everything but the elimination stack once the simplified
+    //  formula has been handed over.
+    void drop_formula() {
+        std::vector<clause_t>().swap(clauses);
+        std::vector<std::vector<unsigned>>().swap(occurs);
+        std::vector<unsigned>().swap(subsumption_queue);
+        std::vector<char>().swap(queued);
+    }
+
+    //Input :   Assignment of a model of the simplified formula, indexed by
+    //          variable and holding the true literal.
+    //
+    //Output:   Assign the eliminated variables so that it is a model of the
+    //          original formula too.
+    void extend_model(int* assignments) const {
+        size_t i = elimination_stack.size();
+        while (i > 0) {
+            size_t size = static_cast<size_t>(elimination_stack[--i]);
+            i -= size;
+            bool satisfied = false;
+            for (size_t j = i + 1; j < i + size && !satisfied; j++) {
+                int literal = elimination_stack[j];
+                satisfied = assignments[abs(literal)] != -literal;
+            }
+            if (!satisfied) {
+                int literal = elimination_stack[i];
+                assignments[abs(literal)] = literal;
+            }
+        }
+    }
+};
+
+#endif /* PREPROCESS_H_ */